@@ -3,8 +3,16 @@
  * @author       : 729DHS   guo_114@outlook.com
  * @date         : 2026-02-20 19:59:31
  * @brief        : ST7789 240x240 屏幕驱动函数头文件,定义了需要的指令宏,以及简单的绘图函数
- * @version      : V1.3
+ * @version      : V1.4
  * V1.3 2026-02-25 00:23:10 对每个命令都标记了含义以及其在手册的详细位置
+ * V1.4 2026-10-19 10:02:41 头文件保护覆盖整个文件,增加像素字节序宏,底层函数移入my_st7789_ll.h
+ * V1.5 2026-10-19 16:40:55 增加SPI总线统计(命令/参数/像素字节,窗口设置次数,总线空闲时间)
+ * V1.6 2026-10-19 17:25:10 增加异步绘制接口,完成回调和忙/空闲查询
+ * V1.7 2026-10-19 18:10:42 等待DMA时进入WFI睡眠,较长的阻塞发送改用DMA
+ * V1.8 2026-10-19 21:05:49 地址窗口影子缓存,跳过未变化的CASET/RASET
+ * V1.9 2026-10-19 21:48:12 ST7789_DrawPixel写合并,增加ST7789_Flush
+ * V1.10 2026-10-20 01:02:47 增加ST7789_RAMFUNC,热点函数放入SRAM运行
+ * V1.11 2026-10-20 08:20:44 ST7789_RAMFUNC改用.RamFunc段,不再需要单独的链接段和复制循环
  */
 
 // DONE 添加对每个指令的说明,以及其所在具体位置
@@ -35,8 +43,6 @@ extern SPI_HandleTypeDef ST7789_SPI_PORT;
 #define ST7789_DC_PORT  GPIOA
 #define ST7789_RST_PORT GPIOA
 
-#endif
-
 #define USING_240X240
 
 /* 选择要使用的显示旋转方向：(0-3) */ 
@@ -94,6 +100,13 @@ extern SPI_HandleTypeDef ST7789_SPI_PORT;
 #define LGRAYBLUE   0XA651
 #define LBBLUE      0X2B12
 
+/**
+ * RGB565 高低字节交换
+ * 面板按高字节在前接收像素,驱动中所有像素缓冲区(图片,精灵,行缓冲)都以面板字节序存放,
+ * 这样缓冲区可以原样交给SPI发送,不需要逐像素转换
+ */
+#define ST7789_SWAP16(c) ((uint16_t)((((c) & 0xFF) << 8) | (((c) >> 8) & 0xFF)))
+
 /* Control Registers and constant codes */
 #define ST7789_NOP     0x00	// P162 NOP,空命令
 #define ST7789_SWRESET 0x01	// P163 软件复位,执行此命令后至少等待5ms,在睡眠进入模式下发送软件复位，发送睡眠退出命令前需要等待120毫秒
@@ -168,4 +181,117 @@ void ST7789_DrawImage(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint
 void ST7789_InvertColors(uint8_t invert);
 
 
-void ST7789_TearEffect(uint8_t tear);
\ No newline at end of file
+void ST7789_TearEffect(uint8_t tear);
+
+/**
+ * 异步绘制接口
+ * 上面的绘制函数都要等最后一个字节发出才返回,18Mbit/s下全屏刷新也要50ms以上;
+ * 异步版本只把事务放入传输队列(my_st7789_xfer)就返回句柄,由SPI DMA中断完成发送
+ *
+ * 句柄:
+ *   提交成功返回非0句柄,按提交顺序递增,事务也按提交顺序完成;
+ *   队列满时不等待,返回ST7789_HANDLE_NONE,调用方可以下个周期再提交
+ * 完成回调:
+ *   在DMA中断中调用,可为NULL;回调中可以继续提交异步绘制,不能调用阻塞绘制函数和ST7789_WaitIdle
+ * 缓冲区生命周期:
+ *   颜色等参数在提交时被复制,调用返回后即可复用;
+ *   ST7789_DrawImage_Async的data不会被复制,必须保持有效且不被修改,
+ *   直到ST7789_IsDone(handle)为真或完成回调被调用,不要传入局部数组
+ * 与阻塞函数混用:
+ *   阻塞函数发送前会等待SPI空闲,因此会先等队列中的事务全部完成,相当于一次ST7789_WaitIdle
+ */
+typedef uint32_t ST7789_Handle;
+#define ST7789_HANDLE_NONE 0
+
+typedef void (*ST7789_DoneCallback)(ST7789_Handle handle, void *ctx);
+
+ST7789_Handle ST7789_Fill_Color_Async(uint16_t color, ST7789_DoneCallback done, void *ctx);
+ST7789_Handle ST7789_Fill_Async(uint16_t xSta, uint16_t ySta, uint16_t xEnd, uint16_t yEnd, uint16_t color,
+                                ST7789_DoneCallback done, void *ctx);
+ST7789_Handle ST7789_DrawImage_Async(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t *data,
+                                     ST7789_DoneCallback done, void *ctx);
+uint8_t ST7789_IsDone(ST7789_Handle handle);
+uint8_t ST7789_IsBusy(void);
+void ST7789_WaitIdle(void);
+
+/**
+ * 低功耗等待
+ * ST7789_WFI_WAIT 为1时,等待DMA传输结束期间内核执行WFI睡眠,由DMA中断唤醒,而不是空转查询SPI状态
+ * 阻塞发送中不少于 ST7789_DMA_MIN_BYTES 字节的数据缓冲也改用DMA发送并睡眠等待,更短的仍用查询方式,
+ * 因为启动DMA和进出中断的开销比直接发送几个字节还大
+ */
+#ifndef ST7789_WFI_WAIT
+#define ST7789_WFI_WAIT 1
+#endif
+
+#ifndef ST7789_DMA_MIN_BYTES
+#define ST7789_DMA_MIN_BYTES 64
+#endif
+
+/**
+ * 地址窗口影子缓存
+ * 驱动记住面板当前的CASET/RASET,设置窗口时只发送变化的那一个,RAMWR总是发送(它把写指针移回窗口起点);
+ * 竖条,文字行,逐带刷新等场景每个窗口可省下5或10字节
+ * 硬件复位,SWRESET,MADCTL(旋转)和RAMRD会使缓存失效;应用不要绕过驱动直接发送CASET/RASET
+ */
+#ifndef ST7789_WINDOW_CACHE
+#define ST7789_WINDOW_CACHE 1
+#endif
+
+/**
+ * ST7789_DrawPixel写合并
+ * 连续的点(同一行x+1,或同一列y+1)先放入缓冲,缓冲满时打开一个到行尾/列尾的窗口,之后的点直接接在
+ * 同一个RAMWR数据流后面;点不连续,调用ST7789_Flush,或任何其他绘制/命令发送前,缓冲被发出
+ * 逐点绘制的旧代码不用修改,每个点不再各自设置窗口
+ */
+#ifndef ST7789_WC_PIXELS
+#define ST7789_WC_PIXELS 32
+#endif
+#if ST7789_WC_PIXELS < 2
+#error "ST7789_WC_PIXELS must be at least 2"
+#endif
+
+void ST7789_Flush(void);
+
+/**
+ * SPI总线统计
+ * 面板受SPI带宽限制,命令和参数字节相对像素字节的比例是衡量传输效率最直接的指标
+ * 编译期开关,默认打开,定义 ST7789_BUS_STATS=0 可去掉统计代码
+ */
+#ifndef ST7789_BUS_STATS
+#define ST7789_BUS_STATS 1
+#endif
+
+typedef struct {
+  uint32_t cmd_bytes;          // 命令字节(DC低)
+  uint32_t param_bytes;        // 命令参数字节,包括CASET/RASET地址
+  uint32_t pixel_bytes;        // RAMWR之后的像素字节
+  uint32_t window_setups;      // 地址窗口设置次数
+  uint32_t dma_transfers;      // DMA发送次数
+  uint32_t blocking_transfers; // 阻塞发送次数
+  uint64_t idle_cycles;        // 相邻两次发送之间总线空闲的CPU周期数,除以SystemCoreClock得到秒
+} ST7789_BusStats;
+
+#if ST7789_BUS_STATS
+void ST7789_GetBusStats(ST7789_BusStats *stats);
+void ST7789_ResetBusStats(void);
+#endif
+
+/**
+ * SRAM函数
+ * 72MHz下flash需要2个等待周期,预取缓冲只能掩盖顺序取指,循环跳转时仍会停顿;
+ * 标记为ST7789_RAMFUNC的函数放入.RamFunc段(与HAL的__RAM_FUNC相同),CubeMX生成的链接脚本把它并入.data,
+ * 启动代码复制.data时一起从flash复制到SRAM,取指没有等待周期
+ * 只标记行展开,图块合成,传输中断等最内层的循环,每个函数都占用同样大小的RAM;
+ * 构建结束时会列出.data中的函数(objdump标记为F的符号)和各段大小
+ * 主机仿真等非ARM平台上为空
+ */
+#ifndef ST7789_RAMFUNC
+#if defined(__GNUC__) && defined(__arm__)
+#define ST7789_RAMFUNC __attribute__((section(".RamFunc"), noinline))
+#else
+#define ST7789_RAMFUNC
+#endif
+#endif
+
+#endif
@@ -0,0 +1,57 @@
+/**
+ * @name         : my_st7789_affine.h
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-20 05:31:07
+ * @brief        : ST7789 仿射绘制(旋转/缩放)
+ * 表盘指针,旋转表盘,缩放过渡等不再预先渲染每一帧:对目标包围盒逐行反算源坐标,
+ * 源坐标为16.16定点,沿行只做加法;每行先算出落在源图片内的列范围,范围外直接填背景色,
+ * 范围内的循环不做边界判断;最近邻或双线性采样到两个DMA行缓冲中交替发送
+ * 也可以作为着色器(ST7789_Shader_Affine)挂到合成器的层上,背景色设为色键即可叠在表盘上
+ * @version      : V1.0
+ */
+
+#ifndef __ST7789_AFFINE_H__
+#define __ST7789_AFFINE_H__
+
+#include "my_st7789_2.h"
+
+/* 角度单位:一周ST7789_AFFINE_TURN,顺时针为正 */
+#define ST7789_AFFINE_TURN 1024
+
+/* 采样方式 */
+#define ST7789_AFFINE_NEAREST  0 // 最近邻
+#define ST7789_AFFINE_BILINEAR 1 // 双线性
+
+typedef struct {
+  const uint16_t *image;  // 面板字节序,w*h
+  uint16_t w, h;
+  int32_t a, b, c, d;     // 逆变换,16.16:目标右移一列源坐标变化(a,c),下移一行变化(b,d)
+  int32_t tx, ty;         // 目标像素(0,0)中心对应的源坐标,16.16
+  int16_t x0, y0, x1, y1; // 目标包围盒,闭区间;x0>x1表示为空
+  uint16_t bg;            // 源图片以外的像素,面板字节序
+  uint8_t filter;         // ST7789_AFFINE_xxx
+} ST7789_Affine;
+
+/**
+ * ST7789_Affine_Init       绑定源图片,变换为原样放在(0,0),最近邻采样,背景黑色
+ * ST7789_Affine_SetFilter  采样方式和背景色(RGB565)
+ * ST7789_Affine_RotScale   源图片中的支点(px,py)(16.16,像素左上角为整数)放到目标的(x,y),
+ *                          绕支点顺时针旋转angle,缩放scale(16.16,0x10000为原大小),同时算出目标包围盒
+ */
+void ST7789_Affine_Init(ST7789_Affine *t, const uint16_t *image, uint16_t w, uint16_t h);
+void ST7789_Affine_SetFilter(ST7789_Affine *t, uint8_t filter, uint16_t bg);
+void ST7789_Affine_RotScale(ST7789_Affine *t, uint16_t angle, uint32_t scale, int32_t px, int32_t py, int16_t x,
+                            int16_t y);
+
+/**
+ * 绘制目标包围盒,坐标为当前视口中的局部坐标,经过裁剪栈(my_st7789_clip);返回时发送已完成
+ * 旋转时包围盒的四角是背景色,需要透明时改用合成器
+ */
+void ST7789_Affine_Draw(const ST7789_Affine *t);
+
+/**
+ * 着色器形式,ctx为ST7789_Affine*,坐标为屏幕坐标;包围盒以外也按变换采样(通常是背景色)
+ */
+void ST7789_Shader_Affine(uint16_t y, uint16_t x0, uint16_t x1, uint16_t *out, void *ctx);
+
+#endif
@@ -0,0 +1,65 @@
+/**
+ * @name         : my_st7789_arena.h
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-20 01:48:15
+ * @brief        : ST7789 显示栈的静态内存区
+ * 20KB的F103上链接脚本只给堆留了0x200字节,运行时malloc何时失败无法预测;
+ * 显示栈需要的行缓冲,缓存,队列等改为从编译期确定大小的静态数组中划分:
+ *   ST7789_Arena_Alloc 一次性分配,不释放,用于帧缓冲,条带缓冲等常驻内存
+ *   ST7789_Pool_*      固定块大小的命名内存池,用空闲链表O(1)分配和释放,记录使用峰值
+ * 所有块按字对齐,可直接作为DMA缓冲;内存区是普通的.bss数组,链接时与栈一起检查是否放得下,
+ * 不同产品通过ST7789_ARENA_SIZE在缓存大小和栈余量之间取舍
+ * @version      : V1.1
+ * V1.1 2026-10-20 08:02:36 逐行发送和合成器的行缓冲改为从"line"内存池分配;重复释放返回HAL_ERROR
+ */
+
+#ifndef __ST7789_ARENA_H__
+#define __ST7789_ARENA_H__
+
+#include "my_st7789_2.h"
+
+/* 内存区总字节数,按4字节向上取整 */
+#ifndef ST7789_ARENA_SIZE
+#define ST7789_ARENA_SIZE 4096
+#endif
+
+/* 内存池数量上限 */
+#ifndef ST7789_ARENA_MAX_POOLS
+#define ST7789_ARENA_MAX_POOLS 8
+#endif
+
+/* "line"内存池的块数,每块一行(ST7789_WIDTH像素):逐行发送交替使用两块,合成器的临时行一块 */
+#ifndef ST7789_LINE_BLOCKS
+#define ST7789_LINE_BLOCKS 3
+#endif
+
+typedef struct st7789_pool ST7789_Pool;
+
+typedef struct {
+  const char *name;
+  uint16_t block_size; // 对齐后的块大小
+  uint16_t count;      // 块数
+  uint16_t in_use;     // 当前已分配的块数
+  uint16_t high_water; // 同时分配的最大块数
+  uint32_t failures;   // 池空时分配失败的次数
+} ST7789_PoolStats;
+
+/* 输出回调,Dump每行调用一次 */
+typedef void (*ST7789_ArenaSink)(const char *line);
+
+/**
+ * 内存池在初始化阶段创建,之后不能销毁;name只保存指针,应为字符串常量
+ * ST7789_Pool_Alloc/ST7789_Pool_Free在临界区内操作空闲链表,可以在中断中调用
+ */
+void *ST7789_Arena_Alloc(uint32_t size);
+uint32_t ST7789_Arena_Used(void);
+uint32_t ST7789_Arena_Available(void);
+
+ST7789_Pool *ST7789_Pool_Create(const char *name, uint16_t block_size, uint16_t count);
+void *ST7789_Pool_Alloc(ST7789_Pool *pool);
+HAL_StatusTypeDef ST7789_Pool_Free(ST7789_Pool *pool, void *block);
+void ST7789_Pool_GetStats(const ST7789_Pool *pool, ST7789_PoolStats *stats);
+
+void ST7789_Arena_Dump(ST7789_ArenaSink sink);
+
+#endif
@@ -0,0 +1,53 @@
+/**
+ * @name         : my_st7789_backlight.h
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-19 19:02:17
+ * @brief        : ST7789 PWM背光
+ * PA2(ST7789_BLK_PIN)是TIM2_CH3,背光改由TIM2输出PWM,亮度经CIE 1976明度曲线换算成占空比,
+ * 人眼看到的亮度随等级均匀变化;渐变由TIM4的更新事件触发DMA1通道7逐级写TIM2->CCR3,
+ * 启动后不占用CPU,只在结束时进一次中断
+ * 寄存器直接操作,工程中没有HAL TIM驱动;引脚在ST7789_Backlight_Init中改为复用推挽,
+ * 覆盖MX_GPIO_Init中的GPIO输出配置
+ * @version      : V1.0
+ */
+
+#ifndef __ST7789_BACKLIGHT_H__
+#define __ST7789_BACKLIGHT_H__
+
+#include "my_st7789_2.h"
+
+/* 编译期开关,为0时背光仍用ST7789_BLK_Set/Clr开关 */
+#ifndef ST7789_BACKLIGHT_PWM
+#define ST7789_BACKLIGHT_PWM 1
+#endif
+
+/* PWM频率和周期计数,16kHz在可听范围以外 */
+#define ST7789_BL_PWM_HZ     16000
+#define ST7789_BL_PWM_PERIOD 1000
+
+/* 一次渐变最多的级数,渐变表占用2*ST7789_BL_FADE_STEPS字节RAM */
+#define ST7789_BL_FADE_STEPS 32
+
+/* ST7789_Init完成第一帧(全屏白色)后渐亮到的等级和用时;等级为0时保持熄灭,由应用画好第一帧后自行渐亮 */
+#ifndef ST7789_BL_INIT_LEVEL
+#define ST7789_BL_INIT_LEVEL 255
+#endif
+#ifndef ST7789_BL_INIT_FADE_MS
+#define ST7789_BL_INIT_FADE_MS 250
+#endif
+
+#if ST7789_BACKLIGHT_PWM
+
+void ST7789_Backlight_Init(void);
+void ST7789_Backlight_Set(uint8_t level);
+void ST7789_Backlight_FadeTo(uint8_t level, uint16_t ms);
+uint8_t ST7789_Backlight_Get(void);
+uint8_t ST7789_Backlight_IsFading(void);
+uint16_t ST7789_Backlight_Gamma(uint8_t level);
+
+/* 在DMA1_Channel7_IRQHandler中调用 */
+void ST7789_Backlight_DMA_IRQHandler(void);
+
+#endif
+
+#endif
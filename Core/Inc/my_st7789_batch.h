@@ -0,0 +1,45 @@
+/**
+ * @name         : my_st7789_batch.h
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-19 20:31:05
+ * @brief        : ST7789 批量图元
+ * 一次传入点,矩形或水平线段数组,驱动按行/列排序,把相邻的点合并成行程,相邻的同色矩形和线段合并成
+ * 更大的矩形,再用尽量少的地址窗口发送;散点图,点云等每帧上百个点时,开销主要是SPI带宽而不是每次调用
+ * @version      : V1.1
+ * V1.1 2026-10-20 11:38:52 说明重复点的颜色
+ */
+
+#ifndef __ST7789_BATCH_H__
+#define __ST7789_BATCH_H__
+
+#include "my_st7789_2.h"
+
+typedef struct {
+  uint16_t x, y;
+  uint16_t color; // RGB565
+} ST7789_Point;
+
+typedef struct {
+  uint16_t x0, y0, x1, y1; // 闭区间
+  uint16_t color;
+} ST7789_Rect;
+
+typedef struct {
+  uint16_t x, y, len; // 从(x,y)向右len个像素
+  uint16_t color;
+} ST7789_Span;
+
+/**
+ * 数组会被原地排序和合并,调用后内容不再保持原样,这样不需要额外的RAM;
+ * 超出屏幕的部分被裁掉;同一位置出现多次时只保留其中一个颜色,
+ * 其中ST7789_DrawPoints保证是数组中最后一个点的颜色
+ *
+ * ST7789_DrawPoints 阻塞发送,返回时已全部发出
+ * ST7789_FillRects/ST7789_DrawHLines 把合并后的矩形作为填充事务交给传输引擎,排队完成即返回,
+ *   需要同步时调用ST7789_WaitIdle
+ */
+void ST7789_DrawPoints(ST7789_Point *pts, uint16_t n);
+void ST7789_FillRects(ST7789_Rect *rects, uint16_t n);
+void ST7789_DrawHLines(ST7789_Span *spans, uint16_t n);
+
+#endif
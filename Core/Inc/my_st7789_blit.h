@@ -0,0 +1,36 @@
+/**
+ * @name         : my_st7789_blit.h
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-20 04:50:31
+ * @brief        : ST7789 图片旋转/镜像绘制
+ * 不在CPU上变换像素:绘制前临时改写MADCTL的MY/MX/MV位,让面板按变换后的方向写入GRAM,
+ * 图片数据仍按原始的行顺序(可以直接从Flash)DMA发送,发送完成后恢复ST7789_ROTATION的设置;
+ * 翻转或旋转的图标,横竖屏两种素材只需要在Flash中保存一份
+ * 坐标经过当前视口和裁剪矩形(my_st7789_clip),只发送可见部分
+ * @version      : V1.0
+ */
+
+#ifndef __ST7789_BLIT_H__
+#define __ST7789_BLIT_H__
+
+#include "my_st7789_2.h"
+
+/* 变换:顺时针旋转角度,可以与ST7789_BLIT_FLIP_X组合;先镜像再旋转 */
+#define ST7789_BLIT_ROT0   0x00
+#define ST7789_BLIT_ROT90  0x01
+#define ST7789_BLIT_ROT180 0x02
+#define ST7789_BLIT_ROT270 0x03
+#define ST7789_BLIT_FLIP_X 0x04                                       // 左右镜像
+#define ST7789_BLIT_FLIP_Y (ST7789_BLIT_FLIP_X | ST7789_BLIT_ROT180) // 上下镜像
+
+/**
+ * @brief 按变换绘制图片
+ * @param x,y 目标矩形左上角,当前视口中的局部坐标
+ * @param w,h 源图片尺寸;旋转90/270度时目标矩形为h*w
+ * @param data 面板字节序的像素数据,w*h
+ * @param transform ST7789_BLIT_xxx
+ * @note 阻塞,返回时已发送完成;会先等待异步队列清空
+ */
+void ST7789_Blit(int16_t x, int16_t y, uint16_t w, uint16_t h, const uint16_t *data, uint8_t transform);
+
+#endif
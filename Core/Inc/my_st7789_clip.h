@@ -0,0 +1,55 @@
+/**
+ * @name         : my_st7789_clip.h
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-20 04:12:55
+ * @brief        : ST7789 裁剪栈和视口
+ * 裁剪栈的每一层是一个屏幕上的裁剪矩形加一个坐标原点:控件压入自己的视口后用局部坐标绘制,
+ * 超出视口,上层裁剪矩形或屏幕的部分在发送之前被裁掉;完全不可见的图元直接返回,SPI上没有任何字节,
+ * 部分可见的图片只发送可见的子矩形
+ * my_st7789_2.h中的基本图形函数(ST7789_DrawPixel,ST7789_Fill,ST7789_DrawLine,ST7789_DrawRectangle,
+ * ST7789_DrawCircle,ST7789_DrawImage)都经过当前视口和裁剪矩形;异步接口,精灵层,帧缓冲等其他模块
+ * 仍使用屏幕坐标,不受影响
+ * @version      : V1.0
+ */
+
+#ifndef __ST7789_CLIP_H__
+#define __ST7789_CLIP_H__
+
+#include "my_st7789_2.h"
+
+/* 裁剪栈深度,不含最底层的整屏 */
+#ifndef ST7789_CLIP_DEPTH
+#define ST7789_CLIP_DEPTH 8
+#endif
+
+/**
+ * 坐标都是当前视口中的局部坐标,矩形为闭区间;栈为空时原点为(0,0),裁剪矩形为整个屏幕
+ *
+ * ST7789_Clip_Push          与当前裁剪矩形求交后压栈,原点不变
+ * ST7789_Clip_PushViewport  原点移到(x,y),裁剪矩形为w*h的视口与当前裁剪矩形的交集
+ * ST7789_Clip_Pop           恢复上一层;栈为空时没有作用
+ * ST7789_Clip_Reset         清空栈
+ * 栈满时压栈返回HAL_ERROR,状态不变;交集为空时仍然压栈,之后的绘制全部被剔除,Pop照常配对
+ */
+HAL_StatusTypeDef ST7789_Clip_Push(int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+HAL_StatusTypeDef ST7789_Clip_PushViewport(int16_t x, int16_t y, uint16_t w, uint16_t h);
+void ST7789_Clip_Pop(void);
+void ST7789_Clip_Reset(void);
+
+/**
+ * 局部矩形是否有可见部分,控件可以用它跳过整段绘制代码
+ */
+uint8_t ST7789_Clip_Visible(int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+
+/**
+ * 局部坐标的绘制函数,颜色为RGB565,图片为面板字节序;都是阻塞的,返回时已发送完成
+ * (ST7789_Clip_DrawPixel与ST7789_DrawPixel一样进入写合并缓冲)
+ */
+void ST7789_Clip_DrawPixel(int16_t x, int16_t y, uint16_t color);
+void ST7789_Clip_Fill(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+void ST7789_Clip_DrawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+void ST7789_Clip_DrawRect(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+void ST7789_Clip_DrawCircle(int16_t cx, int16_t cy, uint16_t r, uint16_t color);
+void ST7789_Clip_DrawImage(int16_t x, int16_t y, uint16_t w, uint16_t h, const uint16_t *data);
+
+#endif
@@ -0,0 +1,84 @@
+/**
+ * @name         : my_st7789_comp.h
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-20 03:36:12
+ * @brief        : ST7789 多层行合成
+ * 最多三层:背景(图片,着色器或纯色),中间层(图标,控件),顶层(文字,标注);
+ * 逐行按层序合成到两个DMA行缓冲中交替发送,屏幕上只写一次最终结果,不再先画图片再画文字,
+ * 没有闪烁,也不重复传输
+ * 每层带包围盒,还可以带逐行覆盖范围:某一行只有一层不透明图片覆盖整个窗口宽度时,
+ * 直接从图片数据(可以在Flash中)DMA发送,不经过行缓冲
+ * @version      : V1.0
+ */
+
+#ifndef __ST7789_COMP_H__
+#define __ST7789_COMP_H__
+
+#include "my_st7789_2.h"
+#include "my_st7789_shader.h"
+
+/* 层数,编号小的在下层 */
+#define ST7789_COMP_LAYERS 3
+
+/* 层的像素来源 */
+#define ST7789_LAYER_SRC_FILL   0 // 纯色矩形
+#define ST7789_LAYER_SRC_IMAGE  1 // RGB565图片,面板字节序,w*h
+#define ST7789_LAYER_SRC_SHADER 2 // 着色器回调,坐标为屏幕坐标
+#define ST7789_LAYER_SRC_MASK   3 // 1bpp位图加单色,位为0处透明;用于文字
+
+/* 层标志位 */
+#define ST7789_LAYER_VISIBLE  0x01 // 可见
+#define ST7789_LAYER_COLORKEY 0x02 // 与key相同的像素透明(图片和着色器层)
+
+/* 逐行覆盖范围,层内列坐标闭区间,x0>x1表示该行没有不透明像素 */
+typedef struct {
+  uint16_t x0, x1;
+} ST7789_RowSpan;
+
+typedef struct {
+  int16_t x, y;   // 左上角屏幕坐标,允许部分移出屏幕
+  uint16_t w, h;  // 包围盒尺寸
+  uint8_t source; // ST7789_LAYER_SRC_xxx
+  uint8_t flags;  // ST7789_LAYER_xxx
+  uint8_t alpha;  // 0~32,32为不透明;小于32时与下层按ST7789_Blend565混合
+  uint16_t color; // 纯色和位图层的颜色,面板字节序
+  uint16_t key;   // 色键,面板字节序
+  const uint16_t *image;
+  const uint8_t *mask; // 每行(w+7)/8字节,高位在前
+  ST7789_ShaderFunc shader;
+  void *ctx;
+  const ST7789_RowSpan *cover; // 可选,h项;为NULL时每行都按整个包围盒宽度处理
+} ST7789_Layer;
+
+/**
+ * 层结构体由调用方保存,挂到合成器期间保持有效;颜色参数为RGB565
+ * 初始化后可见,不透明,不使用色键和覆盖范围
+ */
+void ST7789_Layer_InitFill(ST7789_Layer *l, int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t color);
+void ST7789_Layer_InitImage(ST7789_Layer *l, int16_t x, int16_t y, uint16_t w, uint16_t h, const uint16_t *image);
+void ST7789_Layer_InitShader(ST7789_Layer *l, int16_t x, int16_t y, uint16_t w, uint16_t h, ST7789_ShaderFunc fn,
+                             void *ctx);
+void ST7789_Layer_InitMask(ST7789_Layer *l, int16_t x, int16_t y, uint16_t w, uint16_t h, const uint8_t *mask,
+                           uint16_t color);
+void ST7789_Layer_SetColorKey(ST7789_Layer *l, uint16_t key);
+void ST7789_Layer_SetAlpha(ST7789_Layer *l, uint8_t alpha);
+
+/**
+ * 按色键或位图计算每行最左和最右的不透明像素,写入spans(h项)并设为该层的覆盖范围
+ * 只适用于图片层和位图层,其他层返回0且不修改覆盖范围;图片或位图改变后需要重新计算
+ * @retval 有不透明像素的行数
+ */
+uint16_t ST7789_Layer_BuildCoverage(ST7789_Layer *l, ST7789_RowSpan *spans);
+
+/**
+ * ST7789_Comp_SetLayer   把层挂到第index层,l为NULL时移除;不刷新屏幕
+ * ST7789_Comp_SetBase    没有层覆盖处的颜色,默认黑色
+ * ST7789_Comp_Render     合成并发送屏幕窗口,返回时发送已完成
+ * ST7789_Comp_Move       移动层,合成新旧包围盒
+ */
+HAL_StatusTypeDef ST7789_Comp_SetLayer(uint8_t index, ST7789_Layer *l);
+void ST7789_Comp_SetBase(uint16_t color);
+void ST7789_Comp_Render(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
+void ST7789_Comp_Move(ST7789_Layer *l, int16_t x, int16_t y);
+
+#endif
@@ -0,0 +1,42 @@
+/**
+ * @name         : my_st7789_dlist.h
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-19 11:20:07
+ * @brief        : ST7789 显示列表,把一帧的绘制调用记录到RAM中,提交后由SPI DMA完成中断异步回放
+ * @version      : V1.1
+ * V1.0 2026-10-19 11:20:07 支持填充,直线,矩形,图片;记录时合并冗余操作,提交时重排以减少窗口切换
+ * V1.1 2026-10-19 13:05:32 通过传输引擎回放
+ */
+
+#ifndef __ST7789_DLIST_H__
+#define __ST7789_DLIST_H__
+
+#include "my_st7789_2.h"
+
+/* 每个显示列表可容纳的操作数,共两个列表(一个记录,一个回放),每个操作16字节 */
+#define ST7789_DLIST_MAX_OPS 48
+
+/**
+ * 使用方法:
+ *   ST7789_DList_Begin();
+ *   ST7789_DList_Fill(...); ST7789_DList_Image(...); ...
+ *   ST7789_DList_Submit();   // 立即返回,由DMA中断回放
+ *
+ * 缓冲区生命周期:
+ *   ST7789_DList_Image只记录图片指针,图片数据必须保持有效且不被修改,直到该帧回放结束
+ *   (ST7789_DList_IsBusy()返回0),一般图片放在flash中即可
+ *
+ * 记录满时会自动提交已记录的部分并继续记录,绘制顺序不变
+ */
+void ST7789_DList_Begin(void);
+void ST7789_DList_Fill(uint16_t xSta, uint16_t ySta, uint16_t xEnd, uint16_t yEnd, uint16_t color);
+void ST7789_DList_FillScreen(uint16_t color);
+void ST7789_DList_Line(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color);
+void ST7789_DList_Rect(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color);
+void ST7789_DList_Image(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t *data);
+void ST7789_DList_Submit(void);
+
+uint8_t ST7789_DList_IsBusy(void);
+void ST7789_DList_Wait(void);
+
+#endif
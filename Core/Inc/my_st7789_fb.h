@@ -0,0 +1,58 @@
+/**
+ * @name         : my_st7789_fb.h
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-19 22:30:57
+ * @brief        : ST7789 索引色帧缓冲
+ * 240x240 RGB565帧缓冲需要115KB,放不进20KB RAM;1bpp只要7.2KB,2bpp为14.4KB(4bpp需28.8KB,只适合更小的屏幕)
+ * 绘制只改内存并标记所在行为脏,ST7789_FB_Flush把连续的脏行作为一个窗口,逐行经调色板展开到两个
+ * DMA行缓冲中交替发送,展开下一行与发送上一行同时进行
+ * 有了完整的帧缓冲就可以覆盖绘制,读回像素,用异或画光标
+ * 低分辨率模式(ST7789_FB_Init2x): 120x120逻辑像素,8bpp为14.4KB,4bpp为7.2KB;刷新时展开过程中水平放大2倍,
+ * 每个源行连续发送两次,整帧仍是240x240;游戏和动画界面可以在内存中全速画完一帧再整体刷新
+ * @version      : V1.1
+ * V1.1 2026-10-19 23:12:40 增加8bpp和120x120像素倍增的低分辨率模式
+ */
+
+#ifndef __ST7789_FB_H__
+#define __ST7789_FB_H__
+
+#include "my_st7789_2.h"
+
+/* 每行字节数和整个帧缓冲的字节数,bpp为1/2/4/8 */
+#define ST7789_FB_STRIDE(bpp) ((ST7789_WIDTH * (bpp) + 7) / 8)
+#define ST7789_FB_SIZE(bpp)   ((uint32_t)ST7789_FB_STRIDE(bpp) * ST7789_HEIGHT)
+
+/* 低分辨率模式的逻辑尺寸和帧缓冲字节数 */
+#define ST7789_FB_2X_WIDTH      (ST7789_WIDTH / 2)
+#define ST7789_FB_2X_HEIGHT     (ST7789_HEIGHT / 2)
+#define ST7789_FB_2X_STRIDE(bpp) ((ST7789_FB_2X_WIDTH * (bpp) + 7) / 8)
+#define ST7789_FB_2X_SIZE(bpp)   ((uint32_t)ST7789_FB_2X_STRIDE(bpp) * ST7789_FB_2X_HEIGHT)
+
+/**
+ * 帧缓冲内存由调用方提供(静态数组或分配器),在使用期间保持有效,例如:
+ *   static uint8_t fb_mem[ST7789_FB_SIZE(1)];
+ *   ST7789_FB_Init(1, fb_mem, sizeof(fb_mem));
+ * 像素按行存放,字节内高位在前(最左边的像素)
+ * 低分辨率模式下所有绘制接口的坐标都是逻辑坐标(0~119),刷新时每个逻辑像素显示为2x2
+ * 默认调色板: 8bpp为RGB332(索引即 RRRGGGBB),其他为黑到白的灰阶
+ */
+HAL_StatusTypeDef ST7789_FB_Init(uint8_t bpp, uint8_t *mem, uint32_t size);
+HAL_StatusTypeDef ST7789_FB_Init2x(uint8_t bpp, uint8_t *mem, uint32_t size);
+void ST7789_FB_SetPalette(const uint16_t *colors, uint16_t n);
+uint16_t ST7789_FB_Width(void);
+uint16_t ST7789_FB_Height(void);
+
+void ST7789_FB_Clear(uint8_t index);
+void ST7789_FB_SetPixel(uint16_t x, uint16_t y, uint8_t index);
+uint8_t ST7789_FB_GetPixel(uint16_t x, uint16_t y);
+void ST7789_FB_XorPixel(uint16_t x, uint16_t y, uint8_t mask);
+void ST7789_FB_FillRect(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t index);
+void ST7789_FB_XorRect(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t mask);
+
+/* 直接修改ST7789_FB_Buffer后需要标记脏行 */
+uint8_t *ST7789_FB_Buffer(void);
+void ST7789_FB_MarkDirty(uint16_t y0, uint16_t y1);
+
+void ST7789_FB_Flush(void);
+
+#endif
@@ -0,0 +1,62 @@
+/**
+ * @name         : my_st7789_kern.h
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-20 00:25:36
+ * @brief        : ST7789 像素内核:16位填充,字节序交换,调色板展开,RGB565混合
+ * SPI走DMA之后,CPU准备行缓冲的速度决定了每个行时间内能做多少绘制工作;
+ * 在Cortex-M3上这些函数的主体是my_st7789_kern_m3.s中的汇编循环(LDM/STM成组读写,REV16,
+ * 0x07E0F81F打包乘法),其他平台(如主机仿真)使用同样结果的C实现
+ * @version      : V1.1
+ * V1.1 2026-10-20 10:43:17 增加ST7789_KERN_SELFTEST开关和自检结果读取接口
+ */
+
+#ifndef __ST7789_KERN_H__
+#define __ST7789_KERN_H__
+
+#include "my_st7789_2.h"
+#include "my_st7789_prof.h"
+
+/* 1: 使用汇编内核;0: 全部使用C实现 */
+#ifndef ST7789_KERN_ASM
+#if defined(__GNUC__) && defined(__ARM_ARCH_7M__)
+#define ST7789_KERN_ASM 1
+#else
+#define ST7789_KERN_ASM 0
+#endif
+#endif
+
+/* 1: ST7789_Init开始时运行一次ST7789_Kern_SelfTest,结果用ST7789_Kern_SelfTestErrors读取;
+   默认跟随性能统计开关,调试构建打开 */
+#ifndef ST7789_KERN_SELFTEST
+#define ST7789_KERN_SELFTEST ST7789_PROFILE
+#endif
+
+/**
+ * 像素缓冲按半字对齐即可,首尾不满一个字的像素由C代码处理;
+ * n为像素数,可以为0
+ *
+ * ST7789_Memset16  dst[0..n-1] = v
+ * ST7789_Swap16    dst[i] = src[i]高低字节交换,本机RGB565与面板字节序互转;dst可以等于src
+ * ST7789_Expand8   dst[i] = lut[src[i]]
+ * ST7789_Expand4   dst[i] = lut[第i个4bpp像素],每字节高半字节在前
+ * ST7789_Blend565  dst[i] = src[i]*alpha/32 + dst[i]*(32-alpha)/32,各通道向下取整;
+ *                  alpha为0~32,像素为本机字节序,混合后再用ST7789_Swap16转换
+ */
+void ST7789_Memset16(uint16_t *dst, uint16_t v, uint32_t n);
+void ST7789_Swap16(uint16_t *dst, const uint16_t *src, uint32_t n);
+void ST7789_Expand8(uint16_t *dst, const uint8_t *src, uint32_t n, const uint16_t *lut);
+void ST7789_Expand4(uint16_t *dst, const uint8_t *src, uint32_t n, const uint16_t *lut);
+void ST7789_Blend565(uint16_t *dst, const uint16_t *src, uint32_t n, uint8_t alpha);
+
+/**
+ * 用C参考实现校验以上内核,覆盖不同的对齐和长度
+ * @retval 不一致的次数,0为通过
+ */
+uint32_t ST7789_Kern_SelfTest(void);
+
+/**
+ * @retval 最近一次ST7789_Kern_SelfTest的结果,还没有运行过时为0xFFFFFFFF
+ */
+uint32_t ST7789_Kern_SelfTestErrors(void);
+
+#endif
@@ -0,0 +1,93 @@
+/**
+ * @name         : my_st7789_ll.h
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-19 10:02:41
+ * @brief        : ST7789 驱动内部底层接口,仅供驱动子模块(精灵层等)使用,应用层请勿包含
+ * @version      : V1.5
+ * V1.1 2026-10-19 22:30:57 导出不等待完成的DMA发送和SPI空闲等待
+ * V1.2 2026-10-20 04:12:55 写合并缓冲的入口改为st7789_pixel_put,由裁剪模块调用
+ * V1.3 2026-10-20 04:50:31 导出旋转模式的MADCTL参数和裁剪栈查询,供变换绘制使用
+ * V1.4 2026-10-20 07:40:12 增加逐行生成并发送窗口的st7789_stream_rows,各模块不再各自维护行缓冲
+ * V1.5 2026-10-20 08:02:36 行缓冲从内存区的"line"内存池分配(st7789_line_alloc)
+ */
+
+#ifndef __ST7789_LL_H__
+#define __ST7789_LL_H__
+
+#include "my_st7789_2.h"
+
+void ST7789_WriteCmd(uint8_t cmd);
+void ST7789_WriteData(uint8_t data);
+void st7789_write_data_buf(const uint8_t *data, size_t len);
+void st7789_write_data_dma(const uint8_t *data, uint16_t len);
+void st7789_wait_spi_ready(void);
+void ST7789_SetAddressWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
+void st7789_dwt_enable(void);
+void st7789_pm_activity(void);
+void st7789_pm_reset(void);
+
+/* 地址窗口影子缓存,which为ST7789_WIN_COL或ST7789_WIN_ROW,坐标已加偏移 */
+#define ST7789_WIN_COL 0
+#define ST7789_WIN_ROW 1
+uint8_t st7789_window_same(uint8_t which, uint16_t start, uint16_t end);
+void st7789_window_set(uint8_t which, uint16_t start, uint16_t end);
+void st7789_window_note_cmd(uint8_t cmd);
+void st7789_window_invalidate(void);
+void st7789_pixel_flush(void);
+void st7789_pixel_put(uint16_t x, uint16_t y, uint16_t color);
+uint8_t st7789_rotation_madctl(uint8_t m);
+
+/* 裁剪栈(my_st7789_clip):当前视口原点;局部矩形平移并裁剪为屏幕矩形,返回0表示不可见 */
+void st7789_clip_origin(int32_t *ox, int32_t *oy);
+uint8_t st7789_clip_to_screen(int32_t *x0, int32_t *y0, int32_t *x1, int32_t *y1);
+
+/* 行缓冲(ST7789_WIDTH像素,字对齐),来自my_st7789_arena的"line"内存池;池空时返回NULL */
+uint16_t *st7789_line_alloc(void);
+void st7789_line_free(uint16_t *line);
+
+/**
+ * 行生成函数:生成窗口中的第row行(从0开始),返回要发送的像素(面板字节序,窗口宽度)
+ * line是本行可用的行缓冲(ST7789_WIDTH像素,字对齐),通常写入line并返回它;
+ * 也可以返回其他在发送完成前保持有效的地址,例如图片中的一行或上一次返回的缓冲
+ */
+typedef const uint16_t *(*st7789_row_func)(uint16_t row, uint16_t *line, void *ctx);
+void st7789_stream_rows(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, st7789_row_func fn, void *ctx);
+
+/**
+ * 条件成立时执行一次WFI,用法: while (cond) { ST7789_SLEEP_WHILE(cond); }
+ * 先关中断再检查条件:PRIMASK置位时挂起的中断仍能唤醒WFI,恢复PRIMASK后中断立即执行,
+ * 所以检查和睡眠之间到达的DMA中断不会丢失;SysTick等其他中断也会唤醒,唤醒后重新检查条件
+ */
+#if ST7789_WFI_WAIT
+#define ST7789_SLEEP_WHILE(cond)         \
+  do {                                   \
+    uint32_t primask_ = __get_PRIMASK(); \
+    __disable_irq();                     \
+    if (cond) {                          \
+      __WFI();                           \
+    }                                    \
+    __set_PRIMASK(primask_);             \
+  } while (0)
+#else
+#define ST7789_SLEEP_WHILE(cond)
+#endif
+
+/* 总线统计中的字节类别 */
+#define ST7789_BUS_CMD   0
+#define ST7789_BUS_PARAM 1
+#define ST7789_BUS_PIXEL 2
+
+#if ST7789_BUS_STATS
+void st7789_bus_start(uint8_t kind, uint32_t bytes, uint8_t dma);
+void st7789_bus_done(void);
+void st7789_bus_window(void);
+#define ST7789_BUS_START(kind, bytes, dma) st7789_bus_start(kind, bytes, dma)
+#define ST7789_BUS_DONE()                  st7789_bus_done()
+#define ST7789_BUS_WINDOW()                st7789_bus_window()
+#else
+#define ST7789_BUS_START(kind, bytes, dma)
+#define ST7789_BUS_DONE()
+#define ST7789_BUS_WINDOW()
+#endif
+
+#endif
@@ -0,0 +1,42 @@
+/**
+ * @name         : my_st7789_m2m.h
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-20 02:21:40
+ * @brief        : ST7789 存储器到存储器DMA:行缓冲填充和复制
+ * SPI1_TX占用DMA1通道3,背光渐变占用通道7;这里用通道6的MEM2MEM模式在后台清空行缓冲,
+ * 填充纯色段,或把Flash中的背景行复制到RAM,CPU同时去做混合和字模展开
+ * 通道6与SPI发送同为低优先级,同优先级时编号小的通道先得到总线,SPI DMA不会因此变慢
+ * 寄存器直接操作,不使用中断,完成状态查询DMA1->ISR
+ * @version      : V1.1
+ * V1.1 2026-10-20 09:41:36 传输错误保持到下一次ST7789_M2M_Wait;合成器用它在后台填充底色
+ */
+
+#ifndef __ST7789_M2M_H__
+#define __ST7789_M2M_H__
+
+#include "my_st7789_2.h"
+
+/* 少于该像素数时直接由CPU完成,DMA的启动开销与之相当 */
+#ifndef ST7789_M2M_MIN_PX
+#define ST7789_M2M_MIN_PX 32
+#endif
+
+/**
+ * 同一时刻只有一个传输,启动新传输前先等待上一个结束;启动后立即返回
+ * 目标和源缓冲按半字对齐,n最多65535;两者地址差是4的倍数时按字传输,否则按半字传输
+ * 传输完成(ST7789_M2M_Wait返回)之前不能读写目标缓冲,也不能修改源缓冲
+ *
+ * ST7789_M2M_Fill16  dst[0..n-1] = v,像素值原样写入,不做字节序转换
+ * ST7789_M2M_Copy16  dst[0..n-1] = src[0..n-1],src可以在Flash中;两者不能重叠
+ */
+void ST7789_M2M_Fill16(uint16_t *dst, uint16_t v, uint16_t n);
+void ST7789_M2M_Copy16(uint16_t *dst, const uint16_t *src, uint16_t n);
+
+/**
+ * @retval HAL_ERROR 上一次ST7789_M2M_Wait之后有传输错误(地址不可访问),出错传输的目标缓冲内容不确定;
+ *                   Fill16/Copy16启动前等待上一个传输时不清除错误,所以不会漏报
+ */
+HAL_StatusTypeDef ST7789_M2M_Wait(void);
+uint8_t ST7789_M2M_Busy(void);
+
+#endif
@@ -0,0 +1,27 @@
+/**
+ * @name         : my_st7789_pm.h
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-19 18:10:42
+ * @brief        : ST7789 面板睡眠管理
+ * 一段时间没有绘制后发送SLPIN并关闭背光,下一次绘制(阻塞,异步,显示列表)提交前自动发送SLPOUT唤醒;
+ * SLPIN与SLPOUT之间保持手册要求的120ms间隔(见my_st7789_2.h中ST7789_SLPIN/ST7789_SLPOUT的说明)
+ * @version      : V1.0
+ */
+
+#ifndef __ST7789_PM_H__
+#define __ST7789_PM_H__
+
+#include "my_st7789_2.h"
+
+/* SLPIN和SLPOUT之间的最小间隔,P182/P184 */
+#define ST7789_PM_SLEEP_SPACING_MS 120
+/* SLPOUT之后发送下一条命令前的等待时间,P184 */
+#define ST7789_PM_SLPOUT_DELAY_MS  5
+
+void ST7789_PM_SetTimeout(uint32_t ms);
+void ST7789_PM_Poll(void);
+void ST7789_PM_Sleep(void);
+void ST7789_PM_Wake(void);
+uint8_t ST7789_PM_IsSleeping(void);
+
+#endif
@@ -0,0 +1,88 @@
+/**
+ * @name         : my_st7789_prof.h
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-19 14:12:48
+ * @brief        : ST7789 驱动性能统计,使用Cortex-M3 DWT周期计数器(CYCCNT)
+ * 记录每个驱动入口和底层传输函数的调用次数,总周期,最大周期以及期间传输的字节数
+ * @version      : V1.1
+ * V1.1 2026-10-20 08:41:09 增加填充,图片,变换绘制,仿射,着色器,合成器,图块和帧缓冲入口的统计项
+ */
+
+#ifndef __ST7789_PROF_H__
+#define __ST7789_PROF_H__
+
+#include "my_st7789_2.h"
+
+/**
+ * 编译期开关,默认关闭,关闭时所有统计宏展开为空,不占用代码和RAM
+ * 可在CMakeLists.txt的target_compile_definitions中添加 ST7789_PROFILE=1 打开
+ */
+#ifndef ST7789_PROFILE
+#define ST7789_PROFILE 0
+#endif
+
+/* 统计项,新增入口时在此添加,并同步修改my_st7789_prof.c中的名称表 */
+typedef enum {
+  /* 驱动入口 */
+  ST7789_PROF_INIT = 0,
+  ST7789_PROF_FILL_COLOR,
+  ST7789_PROF_SPRITE_COMPOSE,
+  ST7789_PROF_DLIST_SUBMIT,
+  ST7789_PROF_FILL,
+  ST7789_PROF_DRAW_IMAGE,
+  ST7789_PROF_BLIT,
+  ST7789_PROF_AFFINE_DRAW,
+  ST7789_PROF_SHADE,
+  ST7789_PROF_COMP_RENDER,
+  ST7789_PROF_TILE_RENDER,
+  ST7789_PROF_FB_FLUSH,
+  /* 底层传输 */
+  ST7789_PROF_WRITE_CMD,
+  ST7789_PROF_WRITE_DATA,
+  ST7789_PROF_WRITE_BUF,
+  ST7789_PROF_SET_WINDOW,
+  ST7789_PROF_XFER_SUBMIT,
+  ST7789_PROF_XFER_DMA,
+  ST7789_PROF_COUNT,
+} ST7789_ProfId;
+
+typedef struct {
+  uint32_t calls;
+  uint64_t total_cycles; // 包含内部调用的其他统计项
+  uint32_t max_cycles;
+  uint32_t bytes;        // 各次调用期间经SPI发出的字节数之和
+} ST7789_ProfEntry;
+
+/* 输出回调,Dump每行调用一次,例如把字符串发到串口或SWO */
+typedef void (*ST7789_ProfSink)(const char *line);
+
+#if ST7789_PROFILE
+
+void ST7789_Prof_Init(void);
+void ST7789_Prof_Reset(void);
+const ST7789_ProfEntry *ST7789_Prof_Get(ST7789_ProfId id);
+void ST7789_Prof_Dump(ST7789_ProfSink sink);
+
+/* 以下供驱动内部使用 */
+typedef struct {
+  uint32_t cycles;
+  uint32_t bytes;
+} ST7789_ProfMark;
+
+void ST7789_Prof_Begin(ST7789_ProfMark *mark);
+void ST7789_Prof_End(ST7789_ProfId id, const ST7789_ProfMark *mark);
+void ST7789_Prof_AddBytes(uint32_t n);
+
+#define ST7789_PROF_BEGIN()      ST7789_ProfMark prof_mark_; ST7789_Prof_Begin(&prof_mark_)
+#define ST7789_PROF_END(id)      ST7789_Prof_End(id, &prof_mark_)
+#define ST7789_PROF_BYTES(n)     ST7789_Prof_AddBytes(n)
+
+#else
+
+#define ST7789_PROF_BEGIN()
+#define ST7789_PROF_END(id)
+#define ST7789_PROF_BYTES(n)
+
+#endif
+
+#endif
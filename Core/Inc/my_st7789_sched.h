@@ -0,0 +1,55 @@
+/**
+ * @name         : my_st7789_sched.h
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-19 19:48:30
+ * @brief        : ST7789 绘制任务调度
+ * 绘制任务带优先级和截止时间,按块(整行,约ST7789_SCHED_CHUNK_BYTES字节的RAMWR数据)交给传输引擎;
+ * 每块结束后在DMA中断中重新选择任务,高优先级任务(报警,实时数值)最多等待一个块就能抢占
+ * 低优先级任务(大图传输),被抢占的任务记住已发送到哪一行,之后从该行重新设置窗口继续发送
+ * @version      : V1.0
+ */
+
+#ifndef __ST7789_SCHED_H__
+#define __ST7789_SCHED_H__
+
+#include "my_st7789_2.h"
+
+/* 同时存在的任务数 */
+#define ST7789_SCHED_MAX_JOBS 8
+
+/* 每块的像素数据上限,块按整行切分,至少一行;18Mbit/s下4KB约1.8ms,即高优先级任务的最长等待 */
+#ifndef ST7789_SCHED_CHUNK_BYTES
+#define ST7789_SCHED_CHUNK_BYTES 4096
+#endif
+
+/* 常用优先级,数值越大越优先 */
+#define ST7789_PRIO_BACKGROUND 0
+#define ST7789_PRIO_NORMAL     1
+#define ST7789_PRIO_URGENT     2
+
+/**
+ * 任务完成回调,在DMA中断中调用,可以继续提交任务
+ * @param late 完成时已超过截止时间
+ */
+typedef void (*ST7789_JobCallback)(void *ctx, uint8_t late);
+
+typedef struct {
+  uint16_t x, y, w, h;
+  const uint16_t *image; // 面板字节序的像素数据,为NULL时用color填充
+  uint16_t color;        // RGB565
+  uint8_t priority;      // ST7789_PRIO_xxx
+  uint32_t deadline;     // HAL_GetTick()时刻,0表示没有截止时间
+  ST7789_JobCallback done; // 可为NULL
+  void *ctx;
+} ST7789_Job;
+
+/**
+ * 调度规则: 优先级高的先发送;同优先级截止时间早的先发送(没有截止时间的排在最后);再按提交顺序
+ * 缓冲区生命周期: 任务描述在提交时被复制,image指向的数据必须保持有效直到完成回调
+ */
+HAL_StatusTypeDef ST7789_Sched_Submit(const ST7789_Job *job);
+uint8_t ST7789_Sched_IsBusy(void);
+void ST7789_Sched_Wait(void);
+uint32_t ST7789_Sched_MissedDeadlines(void);
+
+#endif
@@ -0,0 +1,68 @@
+/**
+ * @name         : my_st7789_shader.h
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-20 02:58:03
+ * @brief        : ST7789 逐行着色器
+ * 渐变,仪表盘底纹,波形背景等可以由坐标直接算出的内容不必存成图片:应用提供一个按行生成像素的回调,
+ * 驱动为窗口打开一次地址窗口,在两个DMA行缓冲中交替调用回调并发送,生成下一行与发送上一行同时进行;
+ * 整屏背景不占Flash也不需要帧缓冲,只用两行(960字节)RAM
+ * 内置线性渐变,径向渐变,棋盘格和条纹着色器,渐变可选4x4有序抖动以减轻RGB565的色带
+ * @version      : V1.0
+ */
+
+#ifndef __ST7789_SHADER_H__
+#define __ST7789_SHADER_H__
+
+#include "my_st7789_2.h"
+
+/**
+ * 着色回调
+ * 在out[0..x1-x0]中写入第y行x0~x1列的像素(面板字节序,用ST7789_SWAP16转换);
+ * 回调运行时上一行仍在DMA发送,不能调用其他绘制接口
+ */
+typedef void (*ST7789_ShaderFunc)(uint16_t y, uint16_t x0, uint16_t x1, uint16_t *out, void *ctx);
+
+/**
+ * 用着色器填充窗口(x0,y0)~(x1,y1),坐标超出屏幕时裁剪;返回时发送已完成
+ */
+void ST7789_Shade(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, ST7789_ShaderFunc shader, void *ctx);
+
+// 内置着色器,ctx指向对应的参数结构体,颜色为RGB565;坐标都是屏幕坐标
+
+/* 线性渐变: (x0,y0)处为c0,(x1,y1)处为c1,沿两点连线方向插值,两端以外保持端点颜色 */
+typedef struct {
+  int16_t x0, y0, x1, y1;
+  uint16_t c0, c1;
+  uint8_t dither; // 非0时使用4x4有序抖动
+} ST7789_LinearGradient;
+
+/* 径向渐变: 圆心为c0,距离r处及以外为c1 */
+typedef struct {
+  int16_t cx, cy;
+  uint16_t r;
+  uint16_t c0, c1;
+  uint8_t dither;
+} ST7789_RadialGradient;
+
+/* 棋盘格: size x size的方格,包含(0,0)的方格为c0 */
+typedef struct {
+  uint16_t size;
+  uint16_t c0, c1;
+} ST7789_Checker;
+
+/* 条纹: 宽度为width的c0,c1交替 */
+#define ST7789_STRIPE_H 0 // 水平条纹
+#define ST7789_STRIPE_V 1 // 竖直条纹
+#define ST7789_STRIPE_D 2 // 45度斜条纹
+typedef struct {
+  uint16_t width;
+  uint8_t dir;
+  uint16_t c0, c1;
+} ST7789_Stripes;
+
+void ST7789_Shader_Linear(uint16_t y, uint16_t x0, uint16_t x1, uint16_t *out, void *ctx);
+void ST7789_Shader_Radial(uint16_t y, uint16_t x0, uint16_t x1, uint16_t *out, void *ctx);
+void ST7789_Shader_Checker(uint16_t y, uint16_t x0, uint16_t x1, uint16_t *out, void *ctx);
+void ST7789_Shader_Stripes(uint16_t y, uint16_t x0, uint16_t x1, uint16_t *out, void *ctx);
+
+#endif
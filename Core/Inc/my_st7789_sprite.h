@@ -0,0 +1,57 @@
+/**
+ * @name         : my_st7789_sprite.h
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-19 10:02:41
+ * @brief        : ST7789 精灵层,用于在静态背景上移动光标,指针轴心,状态图标等小图块
+ * @version      : V1.0
+ * V1.0 2026-10-19 10:02:41 支持z序,色键/1bpp遮罩透明,按新旧包围盒的最小窗口重绘
+ */
+
+#ifndef __ST7789_SPRITE_H__
+#define __ST7789_SPRITE_H__
+
+#include "my_st7789_2.h"
+
+/* 同时挂在精灵层上的精灵数量上限 */
+#define ST7789_SPRITE_MAX 8
+
+/* 精灵标志位 */
+#define ST7789_SPRITE_VISIBLE  0x01 // 可见
+#define ST7789_SPRITE_COLORKEY 0x02 // 使用色键透明,与key相同的像素不绘制
+
+/**
+ * 背景行回调
+ * 在out[0 .. x1-x0]中写入第y行x0~x1列的背景像素(面板字节序)
+ * 面板没有接MISO,无法从GRAM读回,所以背景统一由该回调重新生成
+ */
+typedef void (*ST7789_BgFunc)(uint16_t y, uint16_t x0, uint16_t x1, uint16_t *out, void *ctx);
+
+typedef struct {
+  int16_t x, y;          // 左上角坐标,允许部分移出屏幕
+  uint16_t w, h;         // 尺寸
+  const uint16_t *image; // 像素数据,面板字节序,w*h
+  const uint8_t *mask;   // 可选1bpp遮罩,每行(w+7)/8字节,高位在前,1为不透明;为NULL时不使用
+  uint16_t key;          // 色键,面板字节序
+  uint8_t z;             // z序,数值大的绘制在上层
+  uint8_t flags;         // ST7789_SPRITE_xxx
+
+  /* 以下由精灵层维护 */
+  int16_t drawn_x, drawn_y; // 上一次实际绘制到面板的位置
+  uint8_t drawn;            // 面板上是否留有该精灵
+} ST7789_Sprite;
+
+void ST7789_Sprite_Init(ST7789_Sprite *s, uint16_t w, uint16_t h, const uint16_t *image);
+void ST7789_Sprite_SetColorKey(ST7789_Sprite *s, uint16_t key);
+void ST7789_Sprite_SetMask(ST7789_Sprite *s, const uint8_t *mask);
+
+void ST7789_Sprite_SetBackground(ST7789_BgFunc fn, void *ctx);
+void ST7789_Sprite_SetBackgroundColor(uint16_t color);
+
+HAL_StatusTypeDef ST7789_Sprite_Add(ST7789_Sprite *s, uint8_t z);
+void ST7789_Sprite_Remove(ST7789_Sprite *s);
+void ST7789_Sprite_MoveTo(ST7789_Sprite *s, int16_t x, int16_t y);
+void ST7789_Sprite_SetVisible(ST7789_Sprite *s, uint8_t visible);
+void ST7789_Sprite_SetImage(ST7789_Sprite *s, const uint16_t *image);
+void ST7789_Sprite_Redraw(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
+
+#endif
@@ -0,0 +1,46 @@
+/**
+ * @name         : my_st7789_tile.h
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-19 23:40:18
+ * @brief        : ST7789 分块差分刷新
+ * 应用每帧按水平条带重新生成整屏内容,驱动用F103的硬件CRC单元计算条带中每个图块的CRC32,
+ * 与上一帧同一位置的值比较,只把变化的图块发送到面板;仪表盘等每个周期整屏重画的界面,
+ * SPI上只剩真正变化的像素
+ * @version      : V1.1
+ * V1.1 2026-10-20 11:02:39 说明条带缓冲来自内存区
+ */
+
+#ifndef __ST7789_TILE_H__
+#define __ST7789_TILE_H__
+
+#include "my_st7789_2.h"
+
+/* 图块尺寸(像素),条带高度等于图块高度;条带缓冲占ST7789_WIDTH*ST7789_TILE_H*2字节(默认7.5KB),
+   第一次ST7789_Tile_Render时从内存区分配,使用本模块时ST7789_ARENA_SIZE要留出这部分 */
+#define ST7789_TILE_W 16
+#define ST7789_TILE_H 16
+
+#if (ST7789_WIDTH % ST7789_TILE_W) != 0 || (ST7789_HEIGHT % ST7789_TILE_H) != 0 || (ST7789_TILE_W % 2) != 0
+#error "ST7789_TILE_W must be even and divide ST7789_WIDTH, ST7789_TILE_H must divide ST7789_HEIGHT"
+#endif
+
+#define ST7789_TILE_COLS (ST7789_WIDTH / ST7789_TILE_W)
+#define ST7789_TILE_ROWS (ST7789_HEIGHT / ST7789_TILE_H)
+
+/**
+ * 条带回调
+ * 在out中写入第y~y+h-1行的整行像素(面板字节序),共ST7789_WIDTH*h个,逐行连续存放
+ */
+typedef void (*ST7789_BandFunc)(uint16_t y, uint16_t h, uint16_t *out, void *ctx);
+
+/**
+ * ST7789_Tile_Render 逐条带调用render生成一帧,发送内容变化的图块,返回发送的图块数;
+ *   返回时发送已完成
+ * ST7789_Tile_Invalidate 用其他接口在屏幕上绘制过之后调用,下一帧全部图块重新发送
+ * 第一次调用ST7789_Tile_Render时全部图块都会发送;内存区放不下条带缓冲时返回0,什么也不发送
+ * CRC32相同但内容不同的概率约为2^-32,这种情况下该图块会漏发一帧
+ */
+uint16_t ST7789_Tile_Render(ST7789_BandFunc render, void *ctx);
+void ST7789_Tile_Invalidate(void);
+
+#endif
@@ -0,0 +1,50 @@
+/**
+ * @name         : my_st7789_xfer.h
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-19 13:05:32
+ * @brief        : ST7789 中断驱动的传输引擎
+ * 每个绘制事务都是固定的流程: DC低+CASET, DC高+4字节, DC低+RASET, DC高+4字节, DC低+RAMWR, DC高+像素数据
+ * CPU只需要把{窗口,数据源,数量,模式}放入队列,各阶段由SPI DMA完成中断依次推进,结束后调用完成回调
+ * @version      : V1.0
+ */
+
+#ifndef __ST7789_XFER_H__
+#define __ST7789_XFER_H__
+
+#include "my_st7789_2.h"
+
+/* 事务队列长度 */
+#define ST7789_XFER_QUEUE_LEN 8
+
+/* 填充模式使用的图案缓冲大小(像素),每发送这么多像素进一次DMA中断 */
+#define ST7789_XFER_FILL_CHUNK 128
+
+/* 事务模式 */
+#define ST7789_XFER_COPY   0 // 设置窗口后发送src指向的count个像素(面板字节序)
+#define ST7789_XFER_REPEAT 1 // 设置窗口后重复发送count个color
+#define ST7789_XFER_CMD    2 // 发送命令cmd及src指向的count个参数字节,不设置窗口
+
+/* 完成回调,在DMA中断中调用,回调内可以继续提交事务 */
+typedef void (*ST7789_XferCallback)(void *ctx);
+
+typedef struct {
+  uint16_t x0, y0, x1, y1;  // 窗口,闭区间,CMD模式不使用
+  const void *src;          // COPY: 像素数据; CMD: 参数字节
+  uint32_t count;           // COPY/REPEAT: 像素数; CMD: 参数字节数
+  uint16_t color;           // REPEAT: RGB565颜色
+  uint8_t mode;             // ST7789_XFER_xxx
+  uint8_t cmd;              // CMD: 命令字节
+  ST7789_XferCallback done; // 可为NULL
+  void *ctx;
+} ST7789_Xfer;
+
+/**
+ * 缓冲区生命周期:
+ *   描述符在提交时被复制到队列中,提交后可以立即复用;
+ *   src指向的数据不会被复制,必须保持有效直到该事务的完成回调被调用
+ */
+HAL_StatusTypeDef ST7789_Xfer_Submit(const ST7789_Xfer *xfer);
+uint8_t ST7789_Xfer_IsBusy(void);
+void ST7789_Xfer_Wait(void);
+
+#endif
@@ -55,7 +55,9 @@ void SVC_Handler(void);
 void DebugMon_Handler(void);
 void PendSV_Handler(void);
 void SysTick_Handler(void);
+void DMA1_Channel3_IRQHandler(void);
 /* USER CODE BEGIN EFP */
+void DMA1_Channel7_IRQHandler(void);
 
 /* USER CODE END EFP */
 
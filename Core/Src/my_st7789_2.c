@@ -4,9 +4,26 @@
  * @date         : 2026-02-20 19:59:19
  * @brief        :
  * ST7789显示屏驱动程序,参考Github开源,减少了一些不必要的代码,只保留核心初始化以及绘制函数
- * @version      : V1.2
+ * @version      : V1.19
  * V1.1 2026-02-24 09:23:06 补全Init
  * V1.2 2026-02-24 18:11:55 修复了一些代码
+ * V1.3 2026-10-19 10:02:41 底层传输函数通过my_st7789_ll.h提供给驱动子模块(精灵层等)
+ * V1.4 2026-10-19 11:20:07 阻塞传输前等待显示列表的DMA回放结束
+ * V1.5 2026-10-19 14:12:48 入口和底层传输函数加入DWT性能统计
+ * V1.6 2026-10-19 16:40:55 底层传输函数加入SPI总线统计
+ * V1.7 2026-10-19 17:25:10 增加异步绘制接口
+ * V1.8 2026-10-19 18:10:42 等待SPI时WFI睡眠,较长的数据缓冲和全屏填充改用DMA发送,绘制前唤醒面板
+ * V1.9 2026-10-19 19:02:17 初始化时背光保持熄灭,第一帧画完后PWM渐亮
+ * V1.10 2026-10-19 21:05:49 设置窗口时跳过与影子缓存相同的CASET/RASET
+ * V1.11 2026-10-19 21:48:12 实现ST7789_DrawPixel,带写合并缓冲
+ * V1.12 2026-10-19 22:30:57 增加不等待完成的DMA数据发送,供帧缓冲逐行刷新
+ * V1.13 2026-10-20 04:12:55 ST7789_DrawPixel移到裁剪模块,这里只保留写合并缓冲(st7789_pixel_put)
+ * V1.14 2026-10-20 04:50:31 旋转模式的MADCTL参数提取为st7789_rotation_madctl,供变换绘制使用
+ * V1.15 2026-10-20 06:32:15 设置窗口前先等异步队列和SPI空闲,再比较窗口缓存
+ * V1.16 2026-10-20 06:51:40 设置窗口前先冲刷写合并缓冲
+ * V1.17 2026-10-20 07:40:12 增加st7789_stream_rows,集中管理逐行发送的行缓冲
+ * V1.18 2026-10-20 08:02:36 逐行发送的行缓冲改为从内存池分配
+ * V1.19 2026-10-20 10:43:17 ST7789_KERN_SELFTEST打开时初始化先运行像素内核自检
  */
 
 
@@ -15,21 +32,197 @@
 // NEXT 完成其他函数
 
 #include "my_st7789_2.h"
+#include "my_st7789_ll.h"
+#include "my_st7789_backlight.h"
+#include "my_st7789_kern.h"
+#include "my_st7789_prof.h"
+#include "my_st7789_xfer.h"
 #include "stm32f1xx_hal.h"
 
 // GOOD -arch static
 // 写驱动的时候,为保证最底层的函数调用是安全的,用static可以确保只在底层文件中调用,避免接口暴露
+// 精灵层等子模块需要直接组织窗口和像素流,这几个底层函数只在my_st7789_ll.h中声明,应用层不包含该头文件
 
-// 静态函数部分
+// 底层函数部分
+
+static uint8_t st7789_last_cmd; // 最近发送的命令,用于区分参数字节和像素字节
+static uint8_t wc_busy;         // 写合并缓冲正在发送,期间的命令不触发冲刷
+static uint8_t dma_pending;     // st7789_write_data_dma启动的传输尚未计入总线统计
+#define st7789_data_kind() (st7789_last_cmd == ST7789_RAMWR ? ST7789_BUS_PIXEL : ST7789_BUS_PARAM)
+
+#if ST7789_BUS_STATS
+static ST7789_BusStats bus_stats;
+static uint32_t bus_last_end; // 上一次发送结束时的CYCCNT
+static uint8_t bus_last_valid;
+
+/**
+ * @brief 记录一次发送的开始,累加字节数和与上一次发送之间的空闲时间
+ * @note 主循环和DMA中断都会调用
+ */
+void st7789_bus_start(uint8_t kind, uint32_t bytes, uint8_t dma) {
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  if (bus_last_valid) {
+    bus_stats.idle_cycles += DWT->CYCCNT - bus_last_end;
+  }
+  if (kind == ST7789_BUS_CMD) {
+    bus_stats.cmd_bytes += bytes;
+  } else if (kind == ST7789_BUS_PIXEL) {
+    bus_stats.pixel_bytes += bytes;
+  } else {
+    bus_stats.param_bytes += bytes;
+  }
+  if (dma) {
+    bus_stats.dma_transfers++;
+  } else {
+    bus_stats.blocking_transfers++;
+  }
+  bus_last_valid = 0;
+  __set_PRIMASK(primask);
+}
+
+/**
+ * @brief 记录一次发送的结束
+ */
+void st7789_bus_done(void) {
+  bus_last_end = DWT->CYCCNT;
+  bus_last_valid = 1;
+}
+
+/**
+ * @brief 记录一次地址窗口设置
+ */
+void st7789_bus_window(void) {
+  bus_stats.window_setups++;
+}
+
+/**
+ * @brief 获取总线统计快照
+ */
+void ST7789_GetBusStats(ST7789_BusStats *stats) {
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  *stats = bus_stats;
+  __set_PRIMASK(primask);
+}
+
+/**
+ * @brief 清零总线统计
+ */
+void ST7789_ResetBusStats(void) {
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  bus_stats = (ST7789_BusStats){0};
+  bus_last_valid = 0;
+  __set_PRIMASK(primask);
+}
+#endif
+
+#if ST7789_WINDOW_CACHE
+static uint16_t win_start[2], win_end[2]; // 按ST7789_WIN_COL/ST7789_WIN_ROW索引
+static uint8_t win_valid;                 // 位0列有效,位1行有效
+#endif
+
+/**
+ * @brief 面板当前的列/行地址是否已经是[start,end]
+ */
+uint8_t st7789_window_same(uint8_t which, uint16_t start, uint16_t end) {
+#if ST7789_WINDOW_CACHE
+  return (win_valid & (1u << which)) && win_start[which] == start && win_end[which] == end;
+#else
+  return 0;
+#endif
+}
+
+/**
+ * @brief CASET/RASET的参数发出后记录到影子缓存
+ */
+void st7789_window_set(uint8_t which, uint16_t start, uint16_t end) {
+#if ST7789_WINDOW_CACHE
+  win_start[which] = start;
+  win_end[which] = end;
+  win_valid |= 1u << which;
+#endif
+}
+
+void st7789_window_invalidate(void) {
+#if ST7789_WINDOW_CACHE
+  win_valid = 0;
+#endif
+}
+
+/**
+ * @brief 每条命令发出前调用,会改变或使窗口失去意义的命令使缓存失效
+ * @note CASET/RASET本身也先失效,参数发完后由st7789_window_set重新记录
+ */
+void st7789_window_note_cmd(uint8_t cmd) {
+#if ST7789_WINDOW_CACHE
+  switch (cmd) {
+  case ST7789_CASET:
+    win_valid &= ~(1u << ST7789_WIN_COL);
+    break;
+  case ST7789_RASET:
+    win_valid &= ~(1u << ST7789_WIN_ROW);
+    break;
+  case ST7789_SWRESET:
+  case ST7789_MADCTL:
+  case ST7789_RAMRD:
+    win_valid = 0;
+    break;
+  default:
+    break;
+  }
+#else
+  (void)cmd;
+#endif
+}
+
+/**
+ * @brief 打开DWT周期计数器,供总线统计和性能统计使用
+ * @note 调试器连接时DEMCR.TRCENA可能已被置位,这里重复置位没有影响
+ */
+void st7789_dwt_enable(void) {
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+#define st7789_spi_busy() (HAL_SPI_GetState(&ST7789_SPI_PORT) != HAL_SPI_STATE_READY)
+
+/**
+ * @brief 等待SPI空闲
+ * @note 显示列表在DMA中断中回放时SPI处于忙状态,阻塞接口需要等它结束后再发送,
+ *       否则HAL_SPI_Transmit会直接返回HAL_BUSY,数据被丢弃;
+ *       只有DMA传输会让主循环看到忙状态,所以等待期间可以WFI睡眠
+ */
+void st7789_wait_spi_ready(void) {
+  while (st7789_spi_busy()) {
+    ST7789_SLEEP_WHILE(st7789_spi_busy());
+  }
+  if (dma_pending) {
+    dma_pending = 0;
+    ST7789_BUS_DONE();
+  }
+}
 
 /**
  * @brief   向ST7789显示屏写入命令
  * @param   cmd - 要发送的命令字节
  * @note    此函数会先将DC引脚置低（命令模式），然后通过SPI发送命令
  */
-static void ST7789_WriteCmd(uint8_t cmd) {
+void ST7789_WriteCmd(uint8_t cmd) {
+  ST7789_PROF_BEGIN();
+  if (!wc_busy) {
+    st7789_pixel_flush(); // 其他命令会打断写合并的RAMWR数据流
+  }
+  st7789_wait_spi_ready();
+  st7789_window_note_cmd(cmd);
   ST7789_DC_Clr(); // 清除DC引脚，设置为命令模式
+  ST7789_BUS_START(ST7789_BUS_CMD, 1, 0);
   HAL_SPI_Transmit(&ST7789_SPI_PORT, &cmd, 1, 1000); // 通过SPI发送命令
+  ST7789_BUS_DONE();
+  st7789_last_cmd = cmd;
+  ST7789_PROF_BYTES(1);
+  ST7789_PROF_END(ST7789_PROF_WRITE_CMD);
 }
 
 
@@ -38,9 +231,15 @@ static void ST7789_WriteCmd(uint8_t cmd) {
  * @param data 要写入的数据字节
  * @note 此函数会先将DC引脚设置为数据模式，然后通过SPI接口发送数据
  */
-static void ST7789_WriteData(uint8_t data) {
+void ST7789_WriteData(uint8_t data) {
+  ST7789_PROF_BEGIN();
+  st7789_wait_spi_ready();
   ST7789_DC_Set();
+  ST7789_BUS_START(st7789_data_kind(), 1, 0);
   HAL_SPI_Transmit(&ST7789_SPI_PORT, &data, 1, 1000);
+  ST7789_BUS_DONE();
+  ST7789_PROF_BYTES(1);
+  ST7789_PROF_END(ST7789_PROF_WRITE_DATA);
 }
 
 
@@ -51,9 +250,42 @@ static void ST7789_WriteData(uint8_t data) {
  * @note    此函数会先将DC引脚置高（数据模式），然后通过SPI发送指定长度的数据
  *          与单个数据写入函数不同，此函数可以一次性发送多个字节的数据
  */
-static void st7789_write_data_buf(const uint8_t *data, size_t len) {
+void st7789_write_data_buf(const uint8_t *data, size_t len) {
+  ST7789_PROF_BEGIN();
+  st7789_wait_spi_ready();
   ST7789_DC_Set(); // 设置DC引脚，切换到数据模式
-  HAL_SPI_Transmit(&hspi1, (uint8_t *)data, len,HAL_MAX_DELAY); // 通过SPI发送数据缓冲区
+  if (len < ST7789_DMA_MIN_BYTES) {
+    ST7789_BUS_START(st7789_data_kind(), len, 0);
+    HAL_SPI_Transmit(&hspi1, (uint8_t *)data, len,HAL_MAX_DELAY); // 通过SPI发送数据缓冲区
+    ST7789_BUS_DONE();
+  } else {
+    // 较长的缓冲用DMA发送,等待期间内核睡眠;单次DMA最多65535字节,按偶数字节分段
+    for (size_t off = 0; off < len;) {
+      uint16_t n = len - off > 0xFFFE ? 0xFFFE : len - off;
+      ST7789_BUS_START(st7789_data_kind(), n, 1);
+      HAL_SPI_Transmit_DMA(&hspi1, (uint8_t *)data + off, n);
+      st7789_wait_spi_ready();
+      ST7789_BUS_DONE();
+      off += n;
+    }
+  }
+  ST7789_PROF_BYTES(len);
+  ST7789_PROF_END(ST7789_PROF_WRITE_BUF);
+}
+
+
+/**
+ * @brief 用DMA发送数据缓冲,启动后立即返回
+ * @param len 不超过65535字节
+ * @note 发送期间data必须保持不变;下一次发送或st7789_wait_spi_ready会等待它结束,
+ *       调用方可以利用这段时间准备下一个缓冲
+ */
+void st7789_write_data_dma(const uint8_t *data, uint16_t len) {
+  st7789_wait_spi_ready();
+  ST7789_DC_Set();
+  ST7789_BUS_START(st7789_data_kind(), len, 1);
+  dma_pending = 1;
+  HAL_SPI_Transmit_DMA(&hspi1, (uint8_t *)data, len);
 }
 
 
@@ -66,74 +298,134 @@ static void st7789_write_data_buf(const uint8_t *data, size_t len) {
  * @note 该函数用于定义后续写入操作的像素区域，设置完成后可通过 ST7789_WriteData
  * 写入像素数据
  */
-static void ST7789_SetAddressWindow(uint16_t x0, uint16_t y0, uint16_t x1,uint16_t y1) {
+void ST7789_SetAddressWindow(uint16_t x0, uint16_t y0, uint16_t x1,uint16_t y1) {
+  ST7789_PROF_BEGIN();
+  // 写合并缓冲冲刷时会设置它自己的窗口,必须在比较窗口缓存之前完成(冲刷过程中调用时wc_busy为1,直接返回)
+  st7789_pixel_flush();
+  // 传输引擎在DMA中断中也会改写窗口缓存,等队列发完再比较,否则排队的事务会在RAMWR之前改掉列/行范围
+  ST7789_Xfer_Wait();
+  st7789_wait_spi_ready();
+  st7789_pm_activity();
+  ST7789_BUS_WINDOW();
   // 计算实际显示坐标（加上偏移量）
   uint16_t x_start = x0 + X_SHIFT, x_end = x1 + X_SHIFT;
   uint16_t y_start = y0 + Y_SHIFT, y_end = y1 + Y_SHIFT;
 
-  /* 设置列地址范围 */
-  ST7789_WriteCmd(ST7789_CASET); // 发送列地址设置命令
-  {
+  /* 设置列地址范围,与面板当前值相同时跳过 */
+  if (!st7789_window_same(ST7789_WIN_COL, x_start, x_end)) {
+    ST7789_WriteCmd(ST7789_CASET); // 发送列地址设置命令
     // 准备列地址数据：起始地址高8位、起始地址低8位、结束地址高8位、结束地址低8位
     uint8_t data[] = {x_start >> 8, x_start & 0xFF, x_end >> 8, x_end & 0xFF};
     st7789_write_data_buf(data, sizeof(data)); // 写入地址数据
+    st7789_window_set(ST7789_WIN_COL, x_start, x_end);
   }
 
   /* 设置行地址范围 */
-  ST7789_WriteCmd(ST7789_RASET); // 发送行地址设置命令
-  {
+  if (!st7789_window_same(ST7789_WIN_ROW, y_start, y_end)) {
+    ST7789_WriteCmd(ST7789_RASET); // 发送行地址设置命令
     // 准备行地址数据：起始地址高8位、起始地址低8位、结束地址高8位、结束地址低8位
     uint8_t data[] = {y_start >> 8, y_start & 0xFF, y_end >> 8, y_end & 0xFF};
     st7789_write_data_buf(data, sizeof(data)); // 写入地址数据
+    st7789_window_set(ST7789_WIN_ROW, y_start, y_end);
   }
 
   /* 进入RAM写入模式 */
   ST7789_WriteCmd(ST7789_RAMWR); // 发送RAM写入命令，后续数据将直接写入显示RAM
+  ST7789_PROF_END(ST7789_PROF_SET_WINDOW);
 }
 
 
 /**
- * @brief 设置ST7789显示屏的显示旋转方向
+ * @brief 逐行生成并发送一个窗口
+ * @param fn 行生成函数,见st7789_row_func
+ * @note 整个窗口只设置一次地址窗口;两个行缓冲从"line"内存池取出交替使用,生成第k行时第k-1行仍在DMA发送,
+ *       只有fn返回当前行缓冲时才切换,返回其他地址(图片行,重复发送的上一行)不占用行缓冲;
+ *       返回时发送已完成,行缓冲已还回内存池;内存池不足时不发送(计入池的failures)
+ */
+void st7789_stream_rows(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, st7789_row_func fn, void *ctx) {
+  uint16_t len = (x1 - x0 + 1) * 2;
+  uint16_t *line[2] = {st7789_line_alloc(), st7789_line_alloc()};
+  uint8_t k = 0;
+
+  if (line[0] != NULL && line[1] != NULL) {
+    ST7789_SetAddressWindow(x0, y0, x1, y1);
+    for (uint16_t row = 0; row <= y1 - y0; row++) {
+      const uint16_t *p = fn(row, line[k], ctx);
+      if (p == line[k]) {
+        k ^= 1;
+      }
+      if (len < ST7789_DMA_MIN_BYTES) {
+        st7789_write_data_buf((const uint8_t *)p, len);
+      } else {
+        st7789_write_data_dma((const uint8_t *)p, len);
+      }
+    }
+    st7789_wait_spi_ready();
+  }
+  st7789_line_free(line[1]);
+  st7789_line_free(line[0]);
+}
+
+
+/**
+ * @brief 旋转模式对应的MADCTL参数
  * @param m 旋转模式，取值范围0-3
  *          0: 正常显示方向（0度）
  *          1: 顺时针旋转90度
  *          2: 顺时针旋转180度
  *          3: 顺时针旋转270度
- * @note 通过配置MADCTL寄存器来控制显示方向，
- *       不同的旋转模式对应不同的内存访问控制参数组合
+ * @note 不同的旋转模式对应不同的内存访问控制参数组合;变换绘制(my_st7789_blit)以它为基准
  */
-static void ST7789_SetRotation(uint8_t m) {
-  ST7789_WriteCmd(ST7789_MADCTL);
+uint8_t st7789_rotation_madctl(uint8_t m) {
   switch (m) {
   case 0:
     // 设置正常显示方向：水平翻转+垂直翻转+RGB模式
-    ST7789_WriteData(ST7789_MADCTL_MX | ST7789_MADCTL_MY | ST7789_MADCTL_RGB);
-    break;
+    return ST7789_MADCTL_MX | ST7789_MADCTL_MY | ST7789_MADCTL_RGB;
   case 1:
     // 设置90度旋转：垂直翻转+行列交换+RGB模式
-    ST7789_WriteData(ST7789_MADCTL_MY | ST7789_MADCTL_MV | ST7789_MADCTL_RGB);
-    break;
-  case 2:
-    // 设置180度旋转：仅RGB模式（无翻转）
-    ST7789_WriteData(ST7789_MADCTL_RGB);
-    break;
+    return ST7789_MADCTL_MY | ST7789_MADCTL_MV | ST7789_MADCTL_RGB;
   case 3:
     // 设置270度旋转：水平翻转+行列交换+RGB模式
-    ST7789_WriteData(ST7789_MADCTL_MX | ST7789_MADCTL_MV | ST7789_MADCTL_RGB);
-    break;
+    return ST7789_MADCTL_MX | ST7789_MADCTL_MV | ST7789_MADCTL_RGB;
   default:
-    break;
+    // 设置180度旋转：仅RGB模式（无翻转）
+    return ST7789_MADCTL_RGB;
   }
 }
 
+/**
+ * @brief 设置ST7789显示屏的显示旋转方向
+ * @param m 旋转模式，取值范围0-3,见st7789_rotation_madctl
+ * @note 通过配置MADCTL寄存器来控制显示方向
+ */
+static void ST7789_SetRotation(uint8_t m) {
+  ST7789_WriteCmd(ST7789_MADCTL);
+  ST7789_WriteData(st7789_rotation_madctl(m));
+}
+
 
 /**
  * @brief ST7789显示屏初始化函数
  * 该函数用于初始化ST7789显示屏，通过控制复位和背光引脚来完成硬件初始化
  */
 void ST7789_Init(void) {
+#if ST7789_PROFILE
+  ST7789_Prof_Init();
+#endif
+#if ST7789_BUS_STATS
+  st7789_dwt_enable();
+#endif
+#if ST7789_KERN_SELFTEST
+  ST7789_Kern_SelfTest(); // 结果由ST7789_Kern_SelfTestErrors读取,不为0时说明像素内核有问题
+#endif
+  ST7789_PROF_BEGIN();
+#if ST7789_BACKLIGHT_PWM
+  ST7789_Backlight_Init(); // 背光先保持熄灭,遮住上电时GRAM中的噪点
+#else
   ST7789_BLK_Set(); // 打开显示屏背光
+#endif
   HAL_Delay(20);    // 等待20ms，确保背光稳定
+  st7789_window_invalidate(); // 硬件复位后CASET/RASET恢复默认值
   ST7789_RST_Clr(); // 复位引脚拉低，开始复位过程
   HAL_Delay(120);   // 等待120ms，保持复位状态
   ST7789_RST_Set(); // 复位引脚拉高，结束复位过程
@@ -183,38 +475,243 @@ void ST7789_Init(void) {
 
   ST7789_WriteCmd(ST7789_INVON);
   ST7789_WriteCmd(ST7789_SLPOUT);
+  st7789_pm_reset();
   ST7789_WriteCmd(ST7789_NORON);
   ST7789_WriteCmd(ST7789_DISPON);
 
   HAL_Delay(50);
   ST7789_Fill_Color(WHITE);
+#if ST7789_BACKLIGHT_PWM
+  ST7789_Backlight_FadeTo(ST7789_BL_INIT_LEVEL, ST7789_BL_INIT_FADE_MS);
+#endif
+  ST7789_PROF_END(ST7789_PROF_INIT);
 }
 
 
 /**
  * @brief 使用指定颜色填充ST7789显示屏全屏
- * @details 该函数通过设置全屏窗口地址，然后将指定颜色数据批量写入整个显示区域，
- *          实现全屏颜色填充功能。颜色数据会自动转换为适合显示的字节序列。
+ * @details 该函数把全屏填充作为重复颜色事务交给DMA传输引擎,然后睡眠等待发送结束,
+ *          不再逐像素调用HAL_SPI_Transmit。
  * @param color 要填充的颜色值，16位RGB565格式
- * @note 函数内部会自动处理\t、\r、\n等特殊字符
- * @see ST7789_SetAddressWindow()
- *      st7789_write_data_buf()
+ * @see ST7789_Fill_Color_Async()
  */
 void ST7789_Fill_Color(uint16_t color) {
-  // 设置全屏窗口
-  ST7789_SetAddressWindow(0, 0, ST7789_WIDTH - 1, ST7789_HEIGHT - 1);
+  ST7789_PROF_BEGIN();
+  ST7789_WaitIdle(); // 保证队列有空位
+  ST7789_Fill_Color_Async(color, NULL, NULL);
+  ST7789_WaitIdle();
+  ST7789_PROF_END(ST7789_PROF_FILL_COLOR);
+}
+
+// 写合并部分
+
+#define WC_DIR_NONE 0 // 只有一个点,方向未定
+#define WC_DIR_H    1
+#define WC_DIR_V    2
+
+static uint16_t wc_buf[ST7789_WC_PIXELS]; // 面板字节序
+static uint16_t wc_count;                 // 缓冲中的点数
+static uint16_t wc_x0, wc_y0;             // 行程起点
+static uint16_t wc_x, wc_y;               // 行程中最后一个点
+static uint8_t wc_dir;
+static uint8_t wc_active; // 有未结束的行程
+static uint8_t wc_stream; // 行程的窗口和RAMWR已经发出,后续数据直接接在后面
+
+/**
+ * @brief 缓冲满,打开到行尾/列尾的窗口并发出缓冲,行程继续
+ */
+static void wc_spill(void) {
+  wc_busy = 1;
+  if (!wc_stream) {
+    ST7789_SetAddressWindow(wc_x0, wc_y0, wc_dir == WC_DIR_H ? ST7789_WIDTH - 1 : wc_x0,
+                            wc_dir == WC_DIR_V ? ST7789_HEIGHT - 1 : wc_y0);
+    wc_stream = 1;
+  }
+  st7789_write_data_buf((const uint8_t *)wc_buf, wc_count * 2);
+  wc_count = 0;
+  wc_busy = 0;
+}
+
+/**
+ * @brief 发出缓冲中的点并结束当前行程
+ * @note 由其他绘制入口和命令发送前自动调用;在完成回调(中断)中提交事务时不冲刷,
+ *       此时传输引擎正在工作,说明主循环已经提交过事务,写合并的RAMWR数据流已经结束
+ */
+void st7789_pixel_flush(void) {
+  if (!wc_active || wc_busy || __get_IPSR() != 0) {
+    return;
+  }
+  if (wc_count > 0) {
+    wc_busy = 1;
+    if (!wc_stream) {
+      ST7789_SetAddressWindow(wc_x0, wc_y0, wc_x, wc_y);
+    }
+    st7789_write_data_buf((const uint8_t *)wc_buf, wc_count * 2);
+    wc_count = 0;
+    wc_busy = 0;
+  }
+  wc_active = 0;
+  wc_stream = 0;
+}
+
+/**
+ * @brief 点放入写合并缓冲
+ * @param x,y 屏幕坐标,调用方(ST7789_Clip_DrawPixel)已经裁剪
+ * @param color RGB565颜色
+ */
+void st7789_pixel_put(uint16_t x, uint16_t y, uint16_t color) {
+  if (wc_active) {
+    if (wc_dir != WC_DIR_V && y == wc_y && x == wc_x + 1) {
+      wc_dir = WC_DIR_H;
+    } else if (wc_dir != WC_DIR_H && x == wc_x && y == wc_y + 1) {
+      wc_dir = WC_DIR_V;
+    } else {
+      st7789_pixel_flush();
+    }
+  }
+  if (!wc_active) {
+    wc_active = 1;
+    wc_dir = WC_DIR_NONE;
+    wc_x0 = x;
+    wc_y0 = y;
+  }
+  wc_buf[wc_count++] = ST7789_SWAP16(color);
+  wc_x = x;
+  wc_y = y;
+  if (wc_count == ST7789_WC_PIXELS) {
+    wc_spill();
+  }
+}
+
+/**
+ * @brief 发出写合并缓冲中的点
+ */
+void ST7789_Flush(void) {
+  st7789_pixel_flush();
+}
 
-  // 预转换颜色为字节序列
-  const uint8_t color_bytes[2] = {
-      (uint8_t)(color >> 8),  // 高字节
-      (uint8_t)(color & 0xFF) // 低字节
+// 异步绘制部分
+
+/* 每个未完成的异步绘制占一个槽位,异步事务数不会超过传输队列长度,句柄取模即可定位 */
+typedef struct {
+  ST7789_Handle handle;
+  ST7789_DoneCallback done;
+  void *ctx;
+} async_slot_t;
+
+static async_slot_t async_slots[ST7789_XFER_QUEUE_LEN];
+static ST7789_Handle async_next = 1;        // 下一个句柄
+static volatile ST7789_Handle async_done_h; // 最近完成的句柄
+
+/**
+ * @brief 传输引擎完成回调,在DMA中断中调用
+ */
+static void async_xfer_done(void *ctx) {
+  async_slot_t *slot = ctx;
+
+  async_done_h = slot->handle;
+  if (slot->done) {
+    slot->done(slot->handle, slot->ctx);
+  }
+}
+
+/**
+ * @brief 分配句柄并提交事务
+ * @retval ST7789_HANDLE_NONE 传输队列已满
+ */
+static ST7789_Handle async_submit(ST7789_Xfer *x, ST7789_DoneCallback done, void *ctx) {
+  st7789_pixel_flush();
+  st7789_pm_activity(); // 面板睡眠时先在关中断之前唤醒
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+
+  ST7789_Handle h = async_next;
+  async_slot_t *slot = &async_slots[h % ST7789_XFER_QUEUE_LEN];
+  slot->handle = h;
+  slot->done = done;
+  slot->ctx = ctx;
+  x->done = async_xfer_done;
+  x->ctx = slot;
+  if (ST7789_Xfer_Submit(x) != HAL_OK) {
+    __set_PRIMASK(primask);
+    return ST7789_HANDLE_NONE;
+  }
+  async_next = h + 1 == ST7789_HANDLE_NONE ? 1 : h + 1;
+
+  __set_PRIMASK(primask);
+  return h;
+}
+
+/**
+ * @brief 异步填充矩形区域
+ * @param xSta,ySta,xEnd,yEnd 闭区间坐标
+ * @param color RGB565颜色
+ * @param done 完成回调,可为NULL
+ * @return 句柄,队列满或坐标无效时返回ST7789_HANDLE_NONE
+ */
+ST7789_Handle ST7789_Fill_Async(uint16_t xSta, uint16_t ySta, uint16_t xEnd, uint16_t yEnd, uint16_t color,
+                                ST7789_DoneCallback done, void *ctx) {
+  if (xSta > xEnd || ySta > yEnd || xEnd >= ST7789_WIDTH || yEnd >= ST7789_HEIGHT) {
+    return ST7789_HANDLE_NONE;
+  }
+  ST7789_Xfer x = {
+      .x0 = xSta, .y0 = ySta, .x1 = xEnd, .y1 = yEnd,
+      .count = (uint32_t)(xEnd - xSta + 1) * (yEnd - ySta + 1),
+      .color = color,
+      .mode = ST7789_XFER_REPEAT,
   };
+  return async_submit(&x, done, ctx);
+}
 
-  // 计算总像素数
-  const uint32_t total_pixels = (uint32_t)ST7789_WIDTH * ST7789_HEIGHT;
+/**
+ * @brief 异步全屏填充
+ */
+ST7789_Handle ST7789_Fill_Color_Async(uint16_t color, ST7789_DoneCallback done, void *ctx) {
+  return ST7789_Fill_Async(0, 0, ST7789_WIDTH - 1, ST7789_HEIGHT - 1, color, done, ctx);
+}
 
-  // 批量发送颜色数据
-  for (uint32_t i = 0; i < total_pixels; i++) {
-    st7789_write_data_buf(color_bytes, sizeof(color_bytes));
+/**
+ * @brief 异步绘制图片
+ * @param data 面板字节序的像素数据,完成前必须保持有效
+ */
+ST7789_Handle ST7789_DrawImage_Async(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t *data,
+                                     ST7789_DoneCallback done, void *ctx) {
+  if (w == 0 || h == 0 || x + w > ST7789_WIDTH || y + h > ST7789_HEIGHT) {
+    return ST7789_HANDLE_NONE;
   }
+  ST7789_Xfer xf = {
+      .x0 = x, .y0 = y, .x1 = x + w - 1, .y1 = y + h - 1,
+      .src = data,
+      .count = (uint32_t)w * h,
+      .mode = ST7789_XFER_COPY,
+  };
+  return async_submit(&xf, done, ctx);
+}
+
+/**
+ * @brief 句柄对应的绘制是否已经完成
+ * @note 事务按提交顺序完成,只需与最近完成的句柄比较
+ */
+uint8_t ST7789_IsDone(ST7789_Handle handle) {
+  if (handle == ST7789_HANDLE_NONE) {
+    return 1;
+  }
+  return (int32_t)(async_done_h - handle) >= 0;
+}
+
+/**
+ * @brief 是否有未完成的传输(异步队列或阻塞发送)
+ */
+uint8_t ST7789_IsBusy(void) {
+  return ST7789_Xfer_IsBusy() || HAL_SPI_GetState(&ST7789_SPI_PORT) != HAL_SPI_STATE_READY;
+}
+
+/**
+ * @brief 等待所有已提交的绘制完成
+ * @note 不能在完成回调中调用
+ */
+void ST7789_WaitIdle(void) {
+  st7789_pixel_flush();
+  ST7789_Xfer_Wait();
+  st7789_wait_spi_ready();
 }
@@ -0,0 +1,305 @@
+/**
+ * @name         : my_st7789_affine.c
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-20 05:31:07
+ * @brief        : ST7789 仿射绘制实现
+ * 目标像素(x,y)中心对应的源坐标 u = tx + a*x + b*y, v = ty + c*x + d*y,16.16定点,
+ * 源像素(i,j)占[i,i+1)x[j,j+1);一行内u,v是x的线性函数,落在源图片内的列是一个连续区间,
+ * 每行对u,v各用两次64位除法求出区间端点(u或v沿行不变时,如不旋转时的v,只做一次范围比较),
+ * 区间内的循环只有加法和查表
+ * 双线性采样把RGB565展开成0x07E0F81F格式,三个通道一次乘法同时插值,权重5位
+ * @version      : V1.3
+ * V1.1 2026-10-20 07:40:12 逐行发送改用st7789_stream_rows
+ * V1.2 2026-10-20 08:41:09 加入性能统计
+ * V1.3 2026-10-20 11:55:14 更正每行除法次数的说明
+ */
+
+#include "my_st7789_affine.h"
+#include "my_st7789_kern.h"
+#include "my_st7789_ll.h"
+#include "my_st7789_prof.h"
+
+/* 四分之一周期正弦表,sin(i*90度/256)*32768 */
+static const uint16_t affine_sin_q[257] = {
+    0, 201, 402, 603, 804, 1005, 1206, 1407, 1608, 1809, 2009, 2210,
+    2411, 2611, 2811, 3012, 3212, 3412, 3612, 3812, 4011, 4211, 4410, 4609,
+    4808, 5007, 5205, 5404, 5602, 5800, 5998, 6195, 6393, 6590, 6787, 6983,
+    7180, 7376, 7571, 7767, 7962, 8157, 8351, 8546, 8740, 8933, 9127, 9319,
+    9512, 9704, 9896, 10088, 10279, 10469, 10660, 10850, 11039, 11228, 11417, 11605,
+    11793, 11980, 12167, 12354, 12540, 12725, 12910, 13095, 13279, 13463, 13646, 13828,
+    14010, 14192, 14373, 14553, 14733, 14912, 15091, 15269, 15447, 15624, 15800, 15976,
+    16151, 16326, 16500, 16673, 16846, 17018, 17190, 17361, 17531, 17700, 17869, 18037,
+    18205, 18372, 18538, 18703, 18868, 19032, 19195, 19358, 19520, 19681, 19841, 20001,
+    20160, 20318, 20475, 20632, 20788, 20943, 21097, 21251, 21403, 21555, 21706, 21856,
+    22006, 22154, 22302, 22449, 22595, 22740, 22884, 23028, 23170, 23312, 23453, 23593,
+    23732, 23870, 24008, 24144, 24279, 24414, 24548, 24680, 24812, 24943, 25073, 25202,
+    25330, 25457, 25583, 25708, 25833, 25956, 26078, 26199, 26320, 26439, 26557, 26674,
+    26791, 26906, 27020, 27133, 27246, 27357, 27467, 27576, 27684, 27791, 27897, 28002,
+    28106, 28209, 28311, 28411, 28511, 28610, 28707, 28803, 28899, 28993, 29086, 29178,
+    29269, 29359, 29448, 29535, 29622, 29707, 29792, 29875, 29957, 30038, 30118, 30196,
+    30274, 30350, 30425, 30499, 30572, 30644, 30715, 30784, 30853, 30920, 30986, 31050,
+    31114, 31177, 31238, 31298, 31357, 31415, 31471, 31527, 31581, 31634, 31686, 31737,
+    31786, 31834, 31881, 31927, 31972, 32015, 32058, 32099, 32138, 32177, 32214, 32251,
+    32286, 32319, 32352, 32383, 32413, 32442, 32470, 32496, 32522, 32546, 32568, 32590,
+    32610, 32629, 32647, 32664, 32679, 32693, 32706, 32718, 32729, 32738, 32746, 32753,
+    32758, 32762, 32766, 32767, 32768,
+};
+
+/**
+ * @brief 正弦和余弦,16.16
+ */
+static void affine_sincos(uint16_t angle, int32_t *s, int32_t *c) {
+  uint16_t i = angle & 0xFF;
+  int32_t a = affine_sin_q[i] * 2, b = affine_sin_q[256 - i] * 2;
+
+  switch ((angle >> 8) & 0x03) {
+  case 0:
+    *s = a;
+    *c = b;
+    break;
+  case 1:
+    *s = b;
+    *c = -a;
+    break;
+  case 2:
+    *s = -a;
+    *c = -b;
+    break;
+  default:
+    *s = -b;
+    *c = a;
+    break;
+  }
+}
+
+static int16_t affine_clamp16(int64_t v) {
+  return v < -32768 ? -32768 : v > 32767 ? 32767 : (int16_t)v;
+}
+
+void ST7789_Affine_Init(ST7789_Affine *t, const uint16_t *image, uint16_t w, uint16_t h) {
+  t->image = image;
+  t->w = w;
+  t->h = h;
+  t->a = t->d = 0x10000;
+  t->b = t->c = 0;
+  t->tx = t->ty = 0x8000;
+  t->x0 = t->y0 = 0;
+  t->x1 = w - 1;
+  t->y1 = h - 1;
+  t->bg = 0;
+  t->filter = ST7789_AFFINE_NEAREST;
+}
+
+void ST7789_Affine_SetFilter(ST7789_Affine *t, uint8_t filter, uint16_t bg) {
+  t->filter = filter;
+  t->bg = ST7789_SWAP16(bg);
+}
+
+/**
+ * @brief 设置旋转缩放
+ * @note 逆变换为绕支点逆时针旋转angle再缩小scale倍:
+ *       (a,b,c,d) = (cos,sin,-sin,cos)/scale;
+ *       包围盒由源图片四个角的正变换得到
+ */
+void ST7789_Affine_RotScale(ST7789_Affine *t, uint16_t angle, uint32_t scale, int32_t px, int32_t py, int16_t x,
+                            int16_t y) {
+  int32_t s, c;
+
+  if (scale == 0) {
+    t->x0 = t->y0 = 1;
+    t->x1 = t->y1 = 0;
+    return;
+  }
+  affine_sincos(angle, &s, &c);
+  t->a = t->d = (int32_t)((int64_t)c * 65536 / scale);
+  t->b = (int32_t)((int64_t)s * 65536 / scale);
+  t->c = -t->b;
+
+  /* 目标像素(0,0)的中心(0.5,0.5)相对支点的偏移 */
+  int64_t ox = 0x8000 - (int64_t)x * 65536, oy = 0x8000 - (int64_t)y * 65536;
+  t->tx = px + (int32_t)(((int64_t)t->a * ox + (int64_t)t->b * oy) >> 16);
+  t->ty = py + (int32_t)(((int64_t)t->c * ox + (int64_t)t->d * oy) >> 16);
+
+  int64_t x0 = INT64_MAX, y0 = INT64_MAX, x1 = INT64_MIN, y1 = INT64_MIN;
+  for (uint8_t i = 0; i < 4; i++) {
+    int64_t du = ((i & 1) ? (int64_t)t->w * 65536 : 0) - px;
+    int64_t dv = ((i & 2) ? (int64_t)t->h * 65536 : 0) - py;
+    int64_t fx = (int64_t)x * 65536 + ((((int64_t)c * du - (int64_t)s * dv) >> 16) * scale >> 16);
+    int64_t fy = (int64_t)y * 65536 + ((((int64_t)s * du + (int64_t)c * dv) >> 16) * scale >> 16);
+    if (fx < x0) x0 = fx;
+    if (fx > x1) x1 = fx;
+    if (fy < y0) y0 = fy;
+    if (fy > y1) y1 = fy;
+  }
+  t->x0 = affine_clamp16(x0 >> 16);
+  t->y0 = affine_clamp16(y0 >> 16);
+  t->x1 = affine_clamp16((x1 - 1) >> 16);
+  t->y1 = affine_clamp16((y1 - 1) >> 16);
+}
+
+/**
+ * @brief 向下取整除法,d>0
+ */
+static int64_t affine_div_floor(int64_t n, int32_t d) {
+  int64_t q = n / d;
+  if (n % d != 0 && n < 0) {
+    q--;
+  }
+  return q;
+}
+
+/**
+ * @brief f(i)=f0+i*df落在[0,lim)内的i,与[*lo,*hi)求交
+ */
+static void affine_span(int64_t f0, int32_t df, int64_t lim, int32_t *lo, int32_t *hi) {
+  int64_t i0, i1; // 满足条件的i为[i0,i1]
+
+  if (df == 0) {
+    if (f0 < 0 || f0 >= lim) {
+      *hi = *lo;
+    }
+    return;
+  }
+  if (df > 0) {
+    i0 = -affine_div_floor(f0, df);
+    i1 = affine_div_floor(lim - 1 - f0, df);
+  } else {
+    i0 = -affine_div_floor(lim - 1 - f0, -df);
+    i1 = affine_div_floor(f0, -df);
+  }
+  if (i0 > *lo) {
+    *lo = i0 > *hi ? *hi : (int32_t)i0;
+  }
+  if (i1 + 1 < *hi) {
+    *hi = i1 + 1 < *lo ? *lo : (int32_t)(i1 + 1);
+  }
+}
+
+/**
+ * @brief 最近邻采样n个像素,(u,v)都在源图片内
+ * @note 只缩放不旋转时(c==0)整行取自同一源行
+ */
+static ST7789_RAMFUNC void affine_nearest(const ST7789_Affine *t, int32_t u, int32_t v, uint16_t *out, int32_t n) {
+  const uint16_t *img = t->image;
+  int32_t a = t->a, c = t->c;
+
+  if (c == 0) {
+    const uint16_t *row = img + (v >> 16) * t->w;
+    while (n-- > 0) {
+      *out++ = row[u >> 16];
+      u += a;
+    }
+    return;
+  }
+  while (n-- > 0) {
+    *out++ = img[(v >> 16) * t->w + (u >> 16)];
+    u += a;
+    v += c;
+  }
+}
+
+/* 面板字节序像素展开为 00000GGGGGG00000RRRRR000000BBBBB */
+static inline uint32_t affine_expand(uint16_t p) {
+  uint32_t c = ST7789_SWAP16(p);
+  return (c | c << 16) & 0x07E0F81F;
+}
+
+/* 展开格式的插值,f为0~32;每个通道乘32后仍不越过上一个通道 */
+static inline uint32_t affine_lerp(uint32_t p0, uint32_t p1, uint32_t f) {
+  return ((p0 * (32 - f) + p1 * f) >> 5) & 0x07E0F81F;
+}
+
+/**
+ * @brief 双线性采样n个像素,(u,v)都在源图片内
+ * @note 采样点在像素中心之间插值;靠近图片边缘的半个像素内,越界的邻点取边缘像素
+ */
+static ST7789_RAMFUNC void affine_bilinear(const ST7789_Affine *t, int32_t u, int32_t v, uint16_t *out, int32_t n) {
+  const uint16_t *img = t->image;
+  int32_t w = t->w, h = t->h;
+
+  while (n-- > 0) {
+    int32_t su = u - 0x8000, sv = v - 0x8000;
+    int32_t ix = su >> 16, iy = sv >> 16;
+    uint32_t fx = (su >> 11) & 31, fy = (sv >> 11) & 31;
+    int32_t ix1 = ix + 1 < w ? ix + 1 : w - 1, iy1 = iy + 1 < h ? iy + 1 : h - 1;
+    if (ix < 0) {
+      ix = 0;
+    }
+    if (iy < 0) {
+      iy = 0;
+    }
+    const uint16_t *r0 = img + iy * w, *r1 = img + iy1 * w;
+    uint32_t top = affine_lerp(affine_expand(r0[ix]), affine_expand(r0[ix1]), fx);
+    uint32_t bot = affine_lerp(affine_expand(r1[ix]), affine_expand(r1[ix1]), fx);
+    uint32_t p = affine_lerp(top, bot, fy);
+    *out++ = ST7789_SWAP16((uint16_t)((p & 0xF81F) | ((p >> 16) & 0x07E0)));
+    u += t->a;
+    v += t->c;
+  }
+}
+
+/**
+ * @brief 生成目标第y行从x开始的n个像素,坐标为变换的目标坐标
+ */
+static void affine_row(const ST7789_Affine *t, int32_t x, int32_t y, uint16_t n, uint16_t *out) {
+  int64_t u0 = t->tx + (int64_t)t->a * x + (int64_t)t->b * y;
+  int64_t v0 = t->ty + (int64_t)t->c * x + (int64_t)t->d * y;
+  int32_t lo = 0, hi = n;
+
+  affine_span(u0, t->a, (int64_t)t->w << 16, &lo, &hi);
+  affine_span(v0, t->c, (int64_t)t->h << 16, &lo, &hi);
+  if (lo >= hi) {
+    ST7789_Memset16(out, t->bg, n);
+    return;
+  }
+  ST7789_Memset16(out, t->bg, lo);
+  ST7789_Memset16(out + hi, t->bg, n - hi);
+  int32_t u = (int32_t)(u0 + (int64_t)t->a * lo), v = (int32_t)(v0 + (int64_t)t->c * lo);
+  if (t->filter == ST7789_AFFINE_BILINEAR) {
+    affine_bilinear(t, u, v, out + lo, hi - lo);
+  } else {
+    affine_nearest(t, u, v, out + lo, hi - lo);
+  }
+}
+
+typedef struct {
+  const ST7789_Affine *t;
+  int32_t x, y; // 窗口左上角的局部坐标
+  uint16_t n;
+} affine_job_t;
+
+static const uint16_t *affine_stream_row(uint16_t row, uint16_t *line, void *ctx) {
+  const affine_job_t *j = ctx;
+
+  affine_row(j->t, j->x, j->y + row, j->n, line);
+  return line;
+}
+
+/**
+ * @brief 绘制目标包围盒的可见部分
+ * @note 由st7789_stream_rows逐行发送,生成第k行时第k-1行仍在DMA发送
+ */
+void ST7789_Affine_Draw(const ST7789_Affine *t) {
+  int32_t x0 = t->x0, y0 = t->y0, x1 = t->x1, y1 = t->y1;
+  int32_t ox, oy;
+
+  if (t->image == NULL || t->w == 0 || t->h == 0 || !st7789_clip_to_screen(&x0, &y0, &x1, &y1)) {
+    return;
+  }
+  st7789_clip_origin(&ox, &oy);
+
+  ST7789_PROF_BEGIN();
+  affine_job_t j = {t, x0 - ox, y0 - oy, x1 - x0 + 1};
+  st7789_stream_rows(x0, y0, x1, y1, affine_stream_row, &j);
+  ST7789_PROF_END(ST7789_PROF_AFFINE_DRAW);
+}
+
+void ST7789_Shader_Affine(uint16_t y, uint16_t x0, uint16_t x1, uint16_t *out, void *ctx) {
+  const ST7789_Affine *t = ctx;
+
+  if (t->image == NULL || t->w == 0 || t->h == 0) {
+    ST7789_Memset16(out, t->bg, x1 - x0 + 1);
+    return;
+  }
+  affine_row(t, x0, y, x1 - x0 + 1, out);
+}
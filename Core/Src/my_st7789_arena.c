@@ -0,0 +1,196 @@
+/**
+ * @name         : my_st7789_arena.c
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-20 01:48:15
+ * @brief        : ST7789 显示栈的静态内存区实现
+ * 内存区从低地址向上顺序划分,只增不减,已用字节数即峰值;
+ * 内存池的空闲块用块内第一个字保存下一个空闲块的地址,不需要额外的描述表
+ * @version      : V1.2
+ * V1.1 2026-10-20 08:02:36 增加行缓冲池;释放时检查in_use,拒绝重复释放
+ * V1.2 2026-10-20 10:05:14 重复释放改为在空闲链表中查找该块,其他块仍被占用时也能发现
+ */
+
+#include "my_st7789_arena.h"
+#include "my_st7789_ll.h"
+#include <stdio.h>
+
+#define ARENA_WORDS ((ST7789_ARENA_SIZE + 3) / 4)
+
+struct st7789_pool {
+  const char *name;
+  uint8_t *base;
+  void *free_list;
+  uint16_t block_size;
+  uint16_t count;
+  uint16_t in_use;
+  uint16_t high_water;
+  uint32_t failures;
+};
+
+static uint32_t arena_mem[ARENA_WORDS];
+static uint32_t arena_used;     // 字节
+static uint32_t arena_failures; // 内存区或池描述符不足导致的失败次数
+static ST7789_Pool arena_pools[ST7789_ARENA_MAX_POOLS];
+static uint8_t arena_pool_count;
+static ST7789_Pool *arena_line_pool;
+
+/**
+ * @brief 从内存区一次性分配,不能释放
+ * @param size 字节数,按4字节向上取整
+ * @retval 字对齐的内存,内存区不足时返回NULL
+ */
+void *ST7789_Arena_Alloc(uint32_t size) {
+  size = (size + 3) & ~3u;
+  if (size == 0 || size > sizeof(arena_mem) - arena_used) {
+    arena_failures++;
+    return NULL;
+  }
+  void *p = (uint8_t *)arena_mem + arena_used;
+  arena_used += size;
+  return p;
+}
+
+uint32_t ST7789_Arena_Used(void) {
+  return arena_used;
+}
+
+uint32_t ST7789_Arena_Available(void) {
+  return sizeof(arena_mem) - arena_used;
+}
+
+/**
+ * @brief 创建固定块大小的内存池
+ * @param block_size 块字节数,按4字节向上取整
+ * @retval 内存区或池描述符不足时返回NULL
+ */
+ST7789_Pool *ST7789_Pool_Create(const char *name, uint16_t block_size, uint16_t count) {
+  uint32_t bs = (block_size + 3) & ~3u;
+
+  if (bs == 0 || count == 0 || arena_pool_count >= ST7789_ARENA_MAX_POOLS || bs > 0xFFFF) {
+    arena_failures++;
+    return NULL;
+  }
+  uint8_t *base = ST7789_Arena_Alloc(bs * count);
+  if (base == NULL) {
+    return NULL;
+  }
+
+  ST7789_Pool *pool = &arena_pools[arena_pool_count++];
+  pool->name = name;
+  pool->base = base;
+  pool->block_size = bs;
+  pool->count = count;
+  pool->in_use = 0;
+  pool->high_water = 0;
+  pool->failures = 0;
+  pool->free_list = NULL;
+  for (uint16_t i = count; i > 0; i--) { // 链表按地址从低到高
+    void **blk = (void **)(base + (uint32_t)(i - 1) * bs);
+    *blk = pool->free_list;
+    pool->free_list = blk;
+  }
+  return pool;
+}
+
+/**
+ * @brief 从内存池取一块
+ * @retval 池空时返回NULL并计入failures
+ */
+void *ST7789_Pool_Alloc(ST7789_Pool *pool) {
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  void **blk = pool->free_list;
+  if (blk == NULL) {
+    pool->failures++;
+  } else {
+    pool->free_list = *blk;
+    pool->in_use++;
+    if (pool->in_use > pool->high_water) {
+      pool->high_water = pool->in_use;
+    }
+  }
+  __set_PRIMASK(primask);
+  return blk;
+}
+
+/**
+ * @brief 把块还给内存池
+ * @retval HAL_ERROR 块不属于该内存池,或块已经是空闲的(重复释放)
+ */
+HAL_StatusTypeDef ST7789_Pool_Free(ST7789_Pool *pool, void *block) {
+  if (block == NULL || (uint8_t *)block < pool->base) {
+    return HAL_ERROR;
+  }
+  uint32_t off = (uint8_t *)block - pool->base;
+  if (off >= (uint32_t)pool->block_size * pool->count || off % pool->block_size != 0) {
+    return HAL_ERROR;
+  }
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  /* 块已在空闲链表中(重复释放)时拒绝,否则链表中出现两次,之后的分配会多次得到同一块;
+     池的块数很少,遍历链表比为每块维护分配标记更省RAM */
+  for (void **f = pool->free_list; f != NULL; f = *f) {
+    if (f == block) {
+      __set_PRIMASK(primask);
+      return HAL_ERROR;
+    }
+  }
+  *(void **)block = pool->free_list;
+  pool->free_list = block;
+  pool->in_use--;
+  __set_PRIMASK(primask);
+  return HAL_OK;
+}
+
+void ST7789_Pool_GetStats(const ST7789_Pool *pool, ST7789_PoolStats *stats) {
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  stats->name = pool->name;
+  stats->block_size = pool->block_size;
+  stats->count = pool->count;
+  stats->in_use = pool->in_use;
+  stats->high_water = pool->high_water;
+  stats->failures = pool->failures;
+  __set_PRIMASK(primask);
+}
+
+/**
+ * @brief 取一个行缓冲(ST7789_WIDTH像素,字对齐,可作DMA源)
+ * @note 只在主循环中调用;池在第一次使用时创建,块数由ST7789_LINE_BLOCKS决定
+ */
+uint16_t *st7789_line_alloc(void) {
+  if (arena_line_pool == NULL) {
+    arena_line_pool = ST7789_Pool_Create("line", ST7789_WIDTH * 2, ST7789_LINE_BLOCKS);
+    if (arena_line_pool == NULL) {
+      return NULL;
+    }
+  }
+  return ST7789_Pool_Alloc(arena_line_pool);
+}
+
+void st7789_line_free(uint16_t *line) {
+  if (line != NULL) {
+    ST7789_Pool_Free(arena_line_pool, line);
+  }
+}
+
+/**
+ * @brief 输出内存区和各内存池的使用情况
+ * @note 产品定型前运行典型场景后调用,按high_water调整各池块数和ST7789_ARENA_SIZE
+ */
+void ST7789_Arena_Dump(ST7789_ArenaSink sink) {
+  char line[96];
+
+  snprintf(line, sizeof(line), "arena %lu/%lu bytes, %lu failures\r\n", (unsigned long)arena_used,
+           (unsigned long)sizeof(arena_mem), (unsigned long)arena_failures);
+  sink(line);
+  snprintf(line, sizeof(line), "%-16s %6s %6s %6s %6s %8s\r\n", "pool", "block", "count", "used", "peak", "fails");
+  sink(line);
+  for (uint8_t i = 0; i < arena_pool_count; i++) {
+    ST7789_PoolStats s;
+    ST7789_Pool_GetStats(&arena_pools[i], &s);
+    snprintf(line, sizeof(line), "%-16s %6u %6u %6u %6u %8lu\r\n", s.name ? s.name : "-", s.block_size, s.count,
+             s.in_use, s.high_water, (unsigned long)s.failures);
+    sink(line);
+  }
+}
@@ -0,0 +1,178 @@
+/**
+ * @name         : my_st7789_backlight.c
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-19 19:02:17
+ * @brief        : ST7789 PWM背光实现
+ * TIM2: PWM模式1,CH3输出到PA2,CCR3预装载,占空比在下一个PWM周期生效,不会出现毛刺
+ * TIM4: 0.1ms计数,只产生更新事件作为渐变节拍,DIER.UDE把更新事件接到DMA1通道7
+ * DMA1通道7: 存储器到外设,16位,每个节拍把渐变表的下一项写入TIM2->CCR3,传输完成中断停止TIM4
+ * @version      : V1.1
+ * V1.1 2026-10-20 12:44:20 DMA地址寄存器直接写uintptr_t,与M2M模块一致,主机仿真中不截断指针
+ */
+
+#include "my_st7789_backlight.h"
+
+#if ST7789_BACKLIGHT_PWM
+
+/**
+ * CIE 1976明度曲线,等级0~256每8级一个点,值为占空比(0~ST7789_BL_PWM_PERIOD)
+ * 由 Y = ((L+16)/116)^3 (L>8) 或 Y = L/903.3 计算, L = 等级*100/256
+ */
+static const uint16_t bl_cie_table[33] = {
+    0,   3,   7,   10,  15,  20,  27,  35,  44,  55,  68,  82,  98,  116, 137, 159, 184,
+    212, 242, 274, 310, 348, 390, 435, 483, 534, 589, 648, 710, 777, 847, 921, 1000,
+};
+
+static uint16_t bl_fade_buf[ST7789_BL_FADE_STEPS]; // DMA源,渐变期间必须保持有效
+static uint8_t bl_level;                           // 未渐变时的当前等级
+static uint8_t bl_from, bl_to, bl_steps;           // 当前渐变
+static volatile uint8_t bl_fading;
+
+/**
+ * @brief 定时器时钟,APB1分频不为1时定时器时钟是PCLK1的两倍
+ */
+static uint32_t bl_timer_clock(void) {
+  uint32_t clk = HAL_RCC_GetPCLK1Freq();
+
+  if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1) {
+    clk *= 2;
+  }
+  return clk;
+}
+
+/**
+ * @brief 停止正在进行的渐变,TIM2->CCR3保持在已写入的值
+ */
+static void bl_stop(void) {
+  TIM4->CR1 &= ~TIM_CR1_CEN;
+  DMA1_Channel7->CCR = 0;
+  DMA1->IFCR = DMA_IFCR_CGIF7;
+  bl_fading = 0;
+}
+
+/**
+ * @brief 亮度等级换算为占空比
+ * @param level 0~255,与人眼感知亮度成线性关系
+ */
+uint16_t ST7789_Backlight_Gamma(uint8_t level) {
+  uint16_t x = level + (level >> 7); // 0~255 映射到 0~256
+  uint8_t i = x >> 3, f = x & 7;
+
+  if (i >= 32) {
+    return bl_cie_table[32];
+  }
+  return bl_cie_table[i] + (((bl_cie_table[i + 1] - bl_cie_table[i]) * f) >> 3);
+}
+
+/**
+ * @brief 初始化TIM2 PWM,TIM4节拍和DMA1通道7,背光从熄灭开始
+ */
+void ST7789_Backlight_Init(void) {
+  GPIO_InitTypeDef gpio = {0};
+  uint32_t clk = bl_timer_clock();
+
+  __HAL_RCC_GPIOA_CLK_ENABLE();
+  __HAL_RCC_TIM2_CLK_ENABLE();
+  __HAL_RCC_TIM4_CLK_ENABLE();
+  __HAL_RCC_DMA1_CLK_ENABLE();
+
+  /* TIM2_CH3 PWM模式1 */
+  TIM2->CR1 = 0;
+  TIM2->PSC = clk / ((uint32_t)ST7789_BL_PWM_HZ * ST7789_BL_PWM_PERIOD) - 1;
+  TIM2->ARR = ST7789_BL_PWM_PERIOD - 1;
+  TIM2->CCR3 = 0;
+  TIM2->CCMR2 = (TIM2->CCMR2 & ~(TIM_CCMR2_OC3M | TIM_CCMR2_CC3S)) | TIM_CCMR2_OC3M_2 | TIM_CCMR2_OC3M_1 |
+                TIM_CCMR2_OC3PE;
+  TIM2->CCER |= TIM_CCER_CC3E;
+  TIM2->EGR = TIM_EGR_UG;
+  TIM2->CR1 = TIM_CR1_ARPE | TIM_CR1_CEN;
+
+  gpio.Pin = ST7789_BLK_PIN;
+  gpio.Mode = GPIO_MODE_AF_PP;
+  gpio.Speed = GPIO_SPEED_FREQ_LOW;
+  HAL_GPIO_Init(ST7789_BLK_PORT, &gpio);
+
+  /* TIM4计数频率10kHz;先用UG装载预分频,再打开UDE,避免UG产生一次DMA请求 */
+  TIM4->CR1 = 0;
+  TIM4->DIER = 0;
+  TIM4->PSC = clk / 10000 - 1;
+  TIM4->EGR = TIM_EGR_UG;
+  TIM4->SR = 0;
+  TIM4->DIER = TIM_DIER_UDE;
+
+  bl_stop();
+  bl_level = 0;
+  HAL_NVIC_SetPriority(DMA1_Channel7_IRQn, 3, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Channel7_IRQn);
+}
+
+/**
+ * @brief 立即设置亮度,会打断正在进行的渐变
+ */
+void ST7789_Backlight_Set(uint8_t level) {
+  bl_stop();
+  bl_level = level;
+  TIM2->CCR3 = ST7789_Backlight_Gamma(level);
+}
+
+/**
+ * @brief 从当前亮度渐变到指定亮度,立即返回
+ * @param level 目标等级
+ * @param ms 用时,最长65535ms;为0时立即设置
+ * @note 各级在感知亮度上均匀分布;渐变中再次调用会从当时的亮度开始新的渐变
+ */
+void ST7789_Backlight_FadeTo(uint8_t level, uint16_t ms) {
+  uint8_t from = ST7789_Backlight_Get();
+
+  if (ms == 0 || from == level) {
+    ST7789_Backlight_Set(level);
+    return;
+  }
+  bl_stop();
+
+  bl_steps = ms < ST7789_BL_FADE_STEPS ? ms : ST7789_BL_FADE_STEPS;
+  bl_from = from;
+  bl_to = level;
+  for (uint8_t i = 1; i <= bl_steps; i++) {
+    int16_t lv = from + ((int16_t)(level - from) * i) / bl_steps;
+    bl_fade_buf[i - 1] = ST7789_Backlight_Gamma(lv);
+  }
+
+  DMA1_Channel7->CPAR = (uintptr_t)&TIM2->CCR3;
+  DMA1_Channel7->CMAR = (uintptr_t)bl_fade_buf;
+  DMA1_Channel7->CNDTR = bl_steps;
+  DMA1_Channel7->CCR = DMA_CCR_DIR | DMA_CCR_MINC | DMA_CCR_PSIZE_0 | DMA_CCR_MSIZE_0 | DMA_CCR_TCIE;
+  DMA1_Channel7->CCR |= DMA_CCR_EN;
+
+  bl_fading = 1;
+  TIM4->ARR = (uint32_t)ms * 10 / bl_steps - 1;
+  TIM4->CNT = 0;
+  TIM4->CR1 = TIM_CR1_CEN;
+}
+
+/**
+ * @brief 当前亮度等级,渐变中按DMA剩余项数估算
+ */
+uint8_t ST7789_Backlight_Get(void) {
+  if (!bl_fading) {
+    return bl_level;
+  }
+  uint8_t done = bl_steps - DMA1_Channel7->CNDTR;
+  return bl_from + ((int16_t)(bl_to - bl_from) * done) / bl_steps;
+}
+
+uint8_t ST7789_Backlight_IsFading(void) {
+  return bl_fading;
+}
+
+/**
+ * @brief 渐变结束,停止TIM4节拍
+ */
+void ST7789_Backlight_DMA_IRQHandler(void) {
+  if (DMA1->ISR & DMA_ISR_TCIF7) {
+    bl_level = bl_to;
+    bl_stop();
+  }
+}
+
+#endif
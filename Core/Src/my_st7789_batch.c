@@ -0,0 +1,258 @@
+/**
+ * @name         : my_st7789_batch.c
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-19 20:31:05
+ * @brief        : ST7789 批量图元实现
+ * 点: 按(y,x)稳定排序后把同一行相邻的点合并成水平行程;剩下的孤立点再按(x,y)排序合并成竖直行程,
+ *     每个行程一个窗口,颜色经小缓冲连续发送;同一位置的重复点保留输入中最后一个的颜色
+ * 矩形/线段: 先按行合并左右相接的同色图元,再按列合并上下相接且宽度相同的同色图元,
+ *     每个结果作为一个填充事务交给传输引擎
+ * 没有GRAM读回,两个行程之间的空隙无法跳过,所以不把不相接的图元合并到同一窗口
+ * @version      : V1.1
+ * V1.1 2026-10-20 11:38:52 点按行改为稳定的插入排序,重复点以数组中最后一个为准
+ */
+
+#include "my_st7789_batch.h"
+#include "my_st7789_ll.h"
+#include "my_st7789_xfer.h"
+#include <string.h>
+
+/* 点行程的颜色缓冲(像素) */
+#define BATCH_STAGE_PX 32
+
+typedef uint32_t (*batch_key_t)(const void *e);
+
+static uint16_t batch_stage[BATCH_STAGE_PX];
+
+static uint32_t point_row_key(const void *e) {
+  const ST7789_Point *p = e;
+  return ((uint32_t)p->y << 16) | p->x;
+}
+
+static uint32_t point_col_key(const void *e) {
+  const ST7789_Point *p = e;
+  return ((uint32_t)p->x << 16) | p->y;
+}
+
+static uint32_t rect_row_key(const void *e) {
+  const ST7789_Rect *r = e;
+  return ((uint32_t)r->y0 << 20) | ((uint32_t)r->y1 << 10) | r->x0;
+}
+
+static uint32_t rect_col_key(const void *e) {
+  const ST7789_Rect *r = e;
+  return ((uint32_t)r->x0 << 20) | ((uint32_t)r->x1 << 10) | r->y0;
+}
+
+static uint32_t span_row_key(const void *e) {
+  const ST7789_Span *s = e;
+  return ((uint32_t)s->y << 16) | s->x;
+}
+
+static uint32_t span_col_key(const void *e) {
+  const ST7789_Span *s = e;
+  return ((uint32_t)s->x << 20) | ((uint32_t)s->len << 10) | s->y;
+}
+
+/**
+ * @brief 希尔排序(Knuth间隔序列),按key从小到大
+ * @param stable 1: 只做间隔为1的一趟,即插入排序,key相同的元素保持输入顺序
+ * @note 不需要额外RAM,几百个元素时比插入排序快得多,代码也比qsort小;
+ *       插入排序在输入大致有序(按行生成的点)时接近线性,完全乱序时为O(n^2)
+ */
+static void batch_sort(void *base, uint16_t n, size_t size, batch_key_t key, uint8_t stable) {
+  uint8_t *a = base;
+  uint8_t tmp[sizeof(ST7789_Rect)];
+  uint16_t gap = 1;
+
+  while (!stable && gap < n / 3) {
+    gap = gap * 3 + 1;
+  }
+  for (; gap > 0; gap /= 3) {
+    for (uint16_t i = gap; i < n; i++) {
+      memcpy(tmp, a + i * size, size);
+      uint32_t k = key(tmp);
+      uint16_t j = i;
+      while (j >= gap && key(a + (j - gap) * size) > k) {
+        memcpy(a + j * size, a + (j - gap) * size, size);
+        j -= gap;
+      }
+      memcpy(a + j * size, tmp, size);
+    }
+  }
+}
+
+/**
+ * @brief 提交一个填充事务,队列满时睡眠等待
+ */
+static void batch_fill(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color) {
+  ST7789_Xfer x = {
+      .x0 = x0, .y0 = y0, .x1 = x1, .y1 = y1,
+      .count = (uint32_t)(x1 - x0 + 1) * (y1 - y0 + 1),
+      .color = color,
+      .mode = ST7789_XFER_REPEAT,
+  };
+  while (ST7789_Xfer_Submit(&x) != HAL_OK) {
+    ST7789_SLEEP_WHILE(ST7789_Xfer_IsBusy());
+  }
+}
+
+/**
+ * @brief 发送一个点行程,p已按行或按列排好,首尾两点即窗口的两个角
+ */
+static void batch_emit_run(const ST7789_Point *p, uint16_t cnt) {
+  uint16_t k = 0;
+
+  ST7789_SetAddressWindow(p[0].x, p[0].y, p[cnt - 1].x, p[cnt - 1].y);
+  for (uint16_t i = 0; i < cnt; i++) {
+    if (i > 0 && p[i].x == p[i - 1].x && p[i].y == p[i - 1].y) {
+      batch_stage[k - 1] = ST7789_SWAP16(p[i].color); // 重复的点
+      continue;
+    }
+    if (k == BATCH_STAGE_PX) {
+      st7789_write_data_buf((const uint8_t *)batch_stage, k * 2);
+      k = 0;
+    }
+    batch_stage[k++] = ST7789_SWAP16(p[i].color);
+  }
+  st7789_write_data_buf((const uint8_t *)batch_stage, k * 2);
+}
+
+/**
+ * @brief 批量画点
+ * @param pts 点数组,会被原地排序
+ * @note 同一位置出现多次时,数组中最后一个点的颜色生效
+ */
+void ST7789_DrawPoints(ST7789_Point *pts, uint16_t n) {
+  uint16_t m = 0, singles = 0;
+
+  for (uint16_t i = 0; i < n; i++) {
+    if (pts[i].x < ST7789_WIDTH && pts[i].y < ST7789_HEIGHT) {
+      pts[m++] = pts[i];
+    }
+  }
+  batch_sort(pts, m, sizeof(*pts), point_row_key, 1); // 稳定,重复点中最后一个排在最后
+
+  /* 水平行程,孤立点移到数组前部 */
+  for (uint16_t i = 0; i < m;) {
+    uint16_t j = i + 1;
+    while (j < m && pts[j].y == pts[i].y && pts[j].x <= pts[j - 1].x + 1) {
+      j++;
+    }
+    if (pts[j - 1].x != pts[i].x) {
+      batch_emit_run(&pts[i], j - i);
+    } else {
+      pts[singles++] = pts[j - 1];
+    }
+    i = j;
+  }
+
+  /* 竖直行程 */
+  batch_sort(pts, singles, sizeof(*pts), point_col_key, 0); // 孤立点位置各不相同
+  for (uint16_t i = 0; i < singles;) {
+    uint16_t j = i + 1;
+    while (j < singles && pts[j].x == pts[i].x && pts[j].y <= pts[j - 1].y + 1) {
+      j++;
+    }
+    batch_emit_run(&pts[i], j - i);
+    i = j;
+  }
+}
+
+/**
+ * @brief 批量填充矩形
+ * @param rects 矩形数组,会被原地排序合并
+ * @note 重叠的不同颜色矩形之间绘制顺序不确定
+ */
+void ST7789_FillRects(ST7789_Rect *rects, uint16_t n) {
+  uint16_t m = 0;
+
+  for (uint16_t i = 0; i < n; i++) {
+    ST7789_Rect r = rects[i];
+    if (r.x1 >= ST7789_WIDTH) r.x1 = ST7789_WIDTH - 1;
+    if (r.y1 >= ST7789_HEIGHT) r.y1 = ST7789_HEIGHT - 1;
+    if (r.x0 <= r.x1 && r.y0 <= r.y1) {
+      rects[m++] = r;
+    }
+  }
+
+  /* 同一行带内左右相接的合并 */
+  batch_sort(rects, m, sizeof(*rects), rect_row_key, 0);
+  n = m;
+  m = 0;
+  for (uint16_t i = 0; i < n; i++) {
+    ST7789_Rect *p = m > 0 ? &rects[m - 1] : NULL;
+    if (p && p->y0 == rects[i].y0 && p->y1 == rects[i].y1 && p->color == rects[i].color &&
+        rects[i].x0 <= p->x1 + 1) {
+      if (rects[i].x1 > p->x1) {
+        p->x1 = rects[i].x1;
+      }
+    } else {
+      rects[m++] = rects[i];
+    }
+  }
+
+  /* 同一列带内上下相接的合并,直接发送 */
+  batch_sort(rects, m, sizeof(*rects), rect_col_key, 0);
+  for (uint16_t i = 0; i < m;) {
+    uint16_t y1 = rects[i].y1;
+    uint16_t j = i + 1;
+    while (j < m && rects[j].x0 == rects[i].x0 && rects[j].x1 == rects[i].x1 &&
+           rects[j].color == rects[i].color && rects[j].y0 <= y1 + 1) {
+      if (rects[j].y1 > y1) {
+        y1 = rects[j].y1;
+      }
+      j++;
+    }
+    batch_fill(rects[i].x0, rects[i].y0, rects[i].x1, y1, rects[i].color);
+    i = j;
+  }
+}
+
+/**
+ * @brief 批量画水平线段
+ * @param spans 线段数组,会被原地排序合并
+ * @note 宽度相同且上下相接的同色线段合并为一个矩形窗口
+ */
+void ST7789_DrawHLines(ST7789_Span *spans, uint16_t n) {
+  uint16_t m = 0;
+
+  for (uint16_t i = 0; i < n; i++) {
+    ST7789_Span s = spans[i];
+    if (s.x >= ST7789_WIDTH || s.y >= ST7789_HEIGHT || s.len == 0) {
+      continue;
+    }
+    if (s.len > ST7789_WIDTH - s.x) {
+      s.len = ST7789_WIDTH - s.x;
+    }
+    spans[m++] = s;
+  }
+
+  /* 同一行左右相接的合并 */
+  batch_sort(spans, m, sizeof(*spans), span_row_key, 0);
+  n = m;
+  m = 0;
+  for (uint16_t i = 0; i < n; i++) {
+    ST7789_Span *p = m > 0 ? &spans[m - 1] : NULL;
+    if (p && p->y == spans[i].y && p->color == spans[i].color && spans[i].x <= p->x + p->len) {
+      uint16_t end = spans[i].x + spans[i].len;
+      if (end > p->x + p->len) {
+        p->len = end - p->x;
+      }
+    } else {
+      spans[m++] = spans[i];
+    }
+  }
+
+  /* 上下相接的合并成矩形,直接发送 */
+  batch_sort(spans, m, sizeof(*spans), span_col_key, 0);
+  for (uint16_t i = 0; i < m;) {
+    uint16_t j = i + 1;
+    while (j < m && spans[j].x == spans[i].x && spans[j].len == spans[i].len &&
+           spans[j].color == spans[i].color && spans[j].y == spans[j - 1].y + 1) {
+      j++;
+    }
+    batch_fill(spans[i].x, spans[i].y, spans[i].x + spans[i].len - 1, spans[j - 1].y, spans[i].color);
+    i = j;
+  }
+}
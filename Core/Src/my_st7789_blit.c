@@ -0,0 +1,203 @@
+/**
+ * @name         : my_st7789_blit.c
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-20 04:50:31
+ * @brief        : ST7789 图片旋转/镜像绘制实现
+ * 面板按地址计数器(列c,行r)写入GRAM,MADCTL的MY/MX/MV决定计数器到GRAM物理位置的映射,
+ * 8种组合正好是矩形的8种旋转/镜像;把源子矩形左上角及其右边,下边相邻像素的目标位置换算到GRAM,
+ * 找出使这三点的计数器分别为(c,r),(c+1,r),(c,r+1)的组合,窗口就从(c,r)开始,
+ * 源数据按原顺序发送即得到变换后的图像;X_SHIFT/Y_SHIFT在换算到GRAM时加上
+ * @version      : V1.2
+ * V1.1 2026-10-20 07:40:12 逐行发送改用st7789_stream_rows
+ * V1.2 2026-10-20 08:41:09 加入性能统计
+ */
+
+#include "my_st7789_blit.h"
+#include "my_st7789_ll.h"
+#include "my_st7789_prof.h"
+
+/* GRAM尺寸,MADCTL的镜像以整个GRAM为范围 */
+#define BLIT_GRAM_W 240
+#define BLIT_GRAM_H 320
+
+#define BLIT_ORDER_MASK (ST7789_MADCTL_MY | ST7789_MADCTL_MX | ST7789_MADCTL_MV)
+
+typedef struct {
+  int32_t c, r;
+} blit_pt_t;
+
+/**
+ * @brief MADCTL为m时,地址计数器(c,r)对应的GRAM物理位置
+ */
+static blit_pt_t blit_map(uint8_t m, int32_t c, int32_t r) {
+  blit_pt_t p;
+
+  if (m & ST7789_MADCTL_MV) {
+    p.c = (m & ST7789_MADCTL_MX) ? BLIT_GRAM_W - 1 - r : r;
+    p.r = (m & ST7789_MADCTL_MY) ? BLIT_GRAM_H - 1 - c : c;
+  } else {
+    p.c = (m & ST7789_MADCTL_MX) ? BLIT_GRAM_W - 1 - c : c;
+    p.r = (m & ST7789_MADCTL_MY) ? BLIT_GRAM_H - 1 - r : r;
+  }
+  return p;
+}
+
+/**
+ * @brief blit_map的逆映射:GRAM物理位置p对应的地址计数器
+ */
+static blit_pt_t blit_unmap(uint8_t m, blit_pt_t p) {
+  blit_pt_t a;
+
+  if (m & ST7789_MADCTL_MV) {
+    a.c = (m & ST7789_MADCTL_MY) ? BLIT_GRAM_H - 1 - p.r : p.r;
+    a.r = (m & ST7789_MADCTL_MX) ? BLIT_GRAM_W - 1 - p.c : p.c;
+  } else {
+    a.c = (m & ST7789_MADCTL_MX) ? BLIT_GRAM_W - 1 - p.c : p.c;
+    a.r = (m & ST7789_MADCTL_MY) ? BLIT_GRAM_H - 1 - p.r : p.r;
+  }
+  return a;
+}
+
+/**
+ * @brief 源像素(u,v)在目标矩形中的偏移
+ */
+static blit_pt_t blit_dest(uint8_t t, int32_t w, int32_t h, int32_t u, int32_t v) {
+  blit_pt_t d;
+
+  if (t & ST7789_BLIT_FLIP_X) {
+    u = w - 1 - u;
+  }
+  switch (t & 0x03) {
+  case ST7789_BLIT_ROT90:
+    d.c = h - 1 - v;
+    d.r = u;
+    break;
+  case ST7789_BLIT_ROT180:
+    d.c = w - 1 - u;
+    d.r = h - 1 - v;
+    break;
+  case ST7789_BLIT_ROT270:
+    d.c = v;
+    d.r = w - 1 - u;
+    break;
+  default:
+    d.c = u;
+    d.r = v;
+    break;
+  }
+  return d;
+}
+
+/**
+ * @brief blit_dest的逆映射:目标矩形中偏移(dx,dy)处的源像素,结果的c为u,r为v
+ */
+static blit_pt_t blit_src(uint8_t t, int32_t w, int32_t h, int32_t dx, int32_t dy) {
+  blit_pt_t s;
+
+  switch (t & 0x03) {
+  case ST7789_BLIT_ROT90:
+    s.c = dy;
+    s.r = h - 1 - dx;
+    break;
+  case ST7789_BLIT_ROT180:
+    s.c = w - 1 - dx;
+    s.r = h - 1 - dy;
+    break;
+  case ST7789_BLIT_ROT270:
+    s.c = w - 1 - dy;
+    s.r = dx;
+    break;
+  default:
+    s.c = dx;
+    s.r = dy;
+    break;
+  }
+  if (t & ST7789_BLIT_FLIP_X) {
+    s.c = w - 1 - s.c;
+  }
+  return s;
+}
+
+typedef struct {
+  const uint16_t *p; // 源子矩形第一行
+  uint16_t w;        // 图片宽度
+} blit_job_t;
+
+static const uint16_t *blit_row(uint16_t row, uint16_t *line, void *ctx) {
+  const blit_job_t *j = ctx;
+
+  return j->p + (uint32_t)row * j->w;
+}
+
+/**
+ * @brief 绘制图片
+ * @note 源子矩形的各行按原顺序发送:与图片等宽时一次发送,否则逐行直接从图片DMA发送;
+ *       所需的MADCTL与ST7789_ROTATION的设置相同时(不变换)不改写MADCTL
+ */
+void ST7789_Blit(int16_t x, int16_t y, uint16_t w, uint16_t h, const uint16_t *data, uint8_t transform) {
+  uint8_t t = transform & (ST7789_BLIT_FLIP_X | 0x03);
+  uint16_t dw = (t & 0x01) ? h : w, dh = (t & 0x01) ? w : h;
+  int32_t x0 = x, y0 = y, x1 = (int32_t)x + dw - 1, y1 = (int32_t)y + dh - 1;
+  int32_t bx, by;
+
+  if (w == 0 || h == 0 || !st7789_clip_to_screen(&x0, &y0, &x1, &y1)) {
+    return;
+  }
+  st7789_clip_origin(&bx, &by);
+  bx += x;
+  by += y;
+
+  /* 可见目标矩形的两个对角换算回源图片,得到源子矩形 */
+  blit_pt_t a = blit_src(t, w, h, x0 - bx, y0 - by), b = blit_src(t, w, h, x1 - bx, y1 - by);
+  int32_t u0 = a.c < b.c ? a.c : b.c, u1 = a.c < b.c ? b.c : a.c;
+  int32_t v0 = a.r < b.r ? a.r : b.r, v1 = a.r < b.r ? b.r : a.r;
+
+  /* 源(u0,v0),(u0+1,v0),(u0,v0+1)三点目标位置在GRAM中的物理坐标;映射是线性的,
+     子矩形只有一列或一行时越界的相邻点同样可用 */
+  uint8_t base = st7789_rotation_madctl(ST7789_ROTATION);
+  blit_pt_t d00 = blit_dest(t, w, h, u0, v0), d10 = blit_dest(t, w, h, u0 + 1, v0),
+            d01 = blit_dest(t, w, h, u0, v0 + 1);
+  blit_pt_t p00 = blit_map(base, bx + d00.c + X_SHIFT, by + d00.r + Y_SHIFT);
+  blit_pt_t p10 = blit_map(base, bx + d10.c + X_SHIFT, by + d10.r + Y_SHIFT);
+  blit_pt_t p01 = blit_map(base, bx + d01.c + X_SHIFT, by + d01.r + Y_SHIFT);
+
+  /* MY,MX,MV为bit7~5,依次尝试8种组合,其余位保持不变 */
+  uint8_t m = base;
+  blit_pt_t s;
+  uint8_t i;
+  for (i = 0; i < 8; i++) {
+    m = (base & ~BLIT_ORDER_MASK) | (i << 5);
+    s = blit_unmap(m, p00);
+    blit_pt_t s10 = blit_unmap(m, p10), s01 = blit_unmap(m, p01);
+    if (s10.c == s.c + 1 && s10.r == s.r && s01.c == s.c && s01.r == s.r + 1) {
+      break;
+    }
+  }
+  if (i == 8) {
+    return;
+  }
+
+  uint16_t sw = u1 - u0 + 1, sh = v1 - v0 + 1;
+  const uint16_t *p = data + (uint32_t)v0 * w + u0;
+
+  ST7789_PROF_BEGIN();
+  ST7789_WaitIdle(); // 改写MADCTL前等异步队列中的事务按原方向写完
+  if (m != base) {
+    ST7789_WriteCmd(ST7789_MADCTL);
+    ST7789_WriteData(m);
+  }
+  // (s.c,s.r)已是GRAM地址,设置窗口时会再加上偏移,这里先减去(uint16_t回绕后结果不变)
+  uint16_t c0 = s.c - X_SHIFT, r0 = s.r - Y_SHIFT, c1 = c0 + sw - 1, r1 = r0 + sh - 1;
+  if (sw == w) {
+    ST7789_SetAddressWindow(c0, r0, c1, r1);
+    st7789_write_data_buf((const uint8_t *)p, (uint32_t)sw * sh * 2);
+  } else {
+    blit_job_t j = {p, w};
+    st7789_stream_rows(c0, r0, c1, r1, blit_row, &j);
+  }
+  if (m != base) {
+    ST7789_WriteCmd(ST7789_MADCTL); // 恢复,同时使地址窗口缓存失效
+    ST7789_WriteData(base);
+  }
+  ST7789_PROF_END(ST7789_PROF_BLIT);
+}
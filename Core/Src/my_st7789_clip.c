@@ -0,0 +1,314 @@
+/**
+ * @name         : my_st7789_clip.c
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-20 04:12:55
+ * @brief        : ST7789 裁剪栈和视口实现
+ * 栈中保存的是已经换算到屏幕坐标并与下层求交后的矩形,绘制时只需平移一次,再与栈顶矩形比较;
+ * 空矩形用x0>x1表示,任何点都落不进去
+ * @version      : V1.3
+ * V1.1 2026-10-20 04:50:31 导出视口原点和矩形裁剪,供变换绘制使用
+ * V1.2 2026-10-20 07:40:12 图片逐行发送改用st7789_stream_rows
+ * V1.3 2026-10-20 08:41:09 ST7789_Fill和ST7789_DrawImage加入性能统计
+ */
+
+#include "my_st7789_clip.h"
+#include "my_st7789_ll.h"
+#include "my_st7789_prof.h"
+
+typedef struct {
+  int16_t ox, oy;         // 局部坐标原点在屏幕上的位置
+  int16_t x0, y0, x1, y1; // 裁剪矩形,屏幕坐标闭区间
+} clip_state_t;
+
+typedef struct {
+  uint16_t x0, y0, x1, y1;
+} clip_rect_t;
+
+static clip_state_t clip_stack[ST7789_CLIP_DEPTH + 1] = {
+    {0, 0, 0, 0, ST7789_WIDTH - 1, ST7789_HEIGHT - 1},
+};
+static uint8_t clip_top;
+
+#define clip_cur (&clip_stack[clip_top])
+
+/**
+ * @brief 局部矩形平移到屏幕坐标并与当前裁剪矩形求交
+ * @return 0: 交集为空
+ */
+static uint8_t clip_rect(int32_t x0, int32_t y0, int32_t x1, int32_t y1, clip_rect_t *r) {
+  const clip_state_t *c = clip_cur;
+
+  x0 += c->ox;
+  x1 += c->ox;
+  y0 += c->oy;
+  y1 += c->oy;
+  if (x0 < c->x0) x0 = c->x0;
+  if (y0 < c->y0) y0 = c->y0;
+  if (x1 > c->x1) x1 = c->x1;
+  if (y1 > c->y1) y1 = c->y1;
+  if (x0 > x1 || y0 > y1) {
+    return 0;
+  }
+  r->x0 = x0;
+  r->y0 = y0;
+  r->x1 = x1;
+  r->y1 = y1;
+  return 1;
+}
+
+/**
+ * @brief 压入屏幕坐标原点(ox,oy)和局部矩形与当前裁剪矩形的交集
+ */
+static HAL_StatusTypeDef clip_push(int32_t ox, int32_t oy, int32_t x0, int32_t y0, int32_t x1, int32_t y1) {
+  clip_rect_t r;
+
+  if (clip_top >= ST7789_CLIP_DEPTH) {
+    return HAL_ERROR;
+  }
+  clip_state_t *n = &clip_stack[clip_top + 1];
+  if (clip_rect(x0, y0, x1, y1, &r)) {
+    n->x0 = r.x0;
+    n->y0 = r.y0;
+    n->x1 = r.x1;
+    n->y1 = r.y1;
+  } else {
+    n->x0 = n->y0 = 1;
+    n->x1 = n->y1 = 0;
+  }
+  n->ox = ox;
+  n->oy = oy;
+  clip_top++;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef ST7789_Clip_Push(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+  return clip_push(clip_cur->ox, clip_cur->oy, x0, y0, x1, y1);
+}
+
+HAL_StatusTypeDef ST7789_Clip_PushViewport(int16_t x, int16_t y, uint16_t w, uint16_t h) {
+  return clip_push(clip_cur->ox + x, clip_cur->oy + y, x, y, (int32_t)x + w - 1, (int32_t)y + h - 1);
+}
+
+void ST7789_Clip_Pop(void) {
+  if (clip_top > 0) {
+    clip_top--;
+  }
+}
+
+void ST7789_Clip_Reset(void) {
+  clip_top = 0;
+}
+
+uint8_t ST7789_Clip_Visible(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+  clip_rect_t r;
+  return clip_rect(x0, y0, x1, y1, &r);
+}
+
+void st7789_clip_origin(int32_t *ox, int32_t *oy) {
+  *ox = clip_cur->ox;
+  *oy = clip_cur->oy;
+}
+
+uint8_t st7789_clip_to_screen(int32_t *x0, int32_t *y0, int32_t *x1, int32_t *y1) {
+  clip_rect_t r;
+
+  if (!clip_rect(*x0, *y0, *x1, *y1, &r)) {
+    return 0;
+  }
+  *x0 = r.x0;
+  *y0 = r.y0;
+  *x1 = r.x1;
+  *y1 = r.y1;
+  return 1;
+}
+
+/**
+ * @brief 画点
+ * @note 裁剪后进入写合并缓冲
+ */
+void ST7789_Clip_DrawPixel(int16_t x, int16_t y, uint16_t color) {
+  const clip_state_t *c = clip_cur;
+  int32_t sx = x + c->ox, sy = y + c->oy;
+
+  if (sx < c->x0 || sx > c->x1 || sy < c->y0 || sy > c->y1) {
+    return;
+  }
+  st7789_pixel_put(sx, sy, color);
+}
+
+/**
+ * @brief 填充矩形,只发送可见部分
+ */
+void ST7789_Clip_Fill(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+  clip_rect_t r;
+
+  if (!clip_rect(x0, y0, x1, y1, &r)) {
+    return;
+  }
+  ST7789_WaitIdle(); // 保证队列有空位
+  ST7789_Fill_Async(r.x0, r.y0, r.x1, r.y1, color, NULL, NULL);
+  ST7789_WaitIdle();
+}
+
+/**
+ * @brief 画线
+ * @note 水平线和竖直线按矩形填充;斜线先用包围盒剔除,再用Bresenham逐点裁剪
+ */
+void ST7789_Clip_DrawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+  int16_t xa = x0 < x1 ? x0 : x1, xb = x0 < x1 ? x1 : x0;
+  int16_t ya = y0 < y1 ? y0 : y1, yb = y0 < y1 ? y1 : y0;
+
+  if (x0 == x1 || y0 == y1) {
+    ST7789_Clip_Fill(xa, ya, xb, yb, color);
+    return;
+  }
+  if (!ST7789_Clip_Visible(xa, ya, xb, yb)) {
+    return;
+  }
+
+  int32_t dx = xb - xa, dy = -(int32_t)(yb - ya);
+  int8_t step_x = x0 < x1 ? 1 : -1, step_y = y0 < y1 ? 1 : -1;
+  int32_t err = dx + dy;
+  int32_t x = x0, y = y0;
+  for (;;) {
+    ST7789_Clip_DrawPixel(x, y, color);
+    if (x == x1 && y == y1) {
+      break;
+    }
+    int32_t e2 = 2 * err;
+    if (e2 >= dy) {
+      err += dy;
+      x += step_x;
+    }
+    if (e2 <= dx) {
+      err += dx;
+      y += step_y;
+    }
+  }
+}
+
+/**
+ * @brief 画矩形边框,四条边分别裁剪
+ */
+void ST7789_Clip_DrawRect(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+  if (x0 > x1) {
+    int16_t t = x0;
+    x0 = x1;
+    x1 = t;
+  }
+  if (y0 > y1) {
+    int16_t t = y0;
+    y0 = y1;
+    y1 = t;
+  }
+  ST7789_Clip_Fill(x0, y0, x1, y0, color);
+  if (y1 > y0) {
+    ST7789_Clip_Fill(x0, y1, x1, y1, color);
+  }
+  if (y1 - y0 > 1) {
+    ST7789_Clip_Fill(x0, y0 + 1, x0, y1 - 1, color);
+    if (x1 > x0) {
+      ST7789_Clip_Fill(x1, y0 + 1, x1, y1 - 1, color);
+    }
+  }
+}
+
+/**
+ * @brief 中点画圆
+ */
+void ST7789_Clip_DrawCircle(int16_t cx, int16_t cy, uint16_t r, uint16_t color) {
+  if (!ST7789_Clip_Visible(cx - r, cy - r, cx + r, cy + r)) {
+    return;
+  }
+
+  int32_t x = r, y = 0, err = 1 - (int32_t)r;
+  while (x >= y) {
+    ST7789_Clip_DrawPixel(cx + x, cy + y, color);
+    ST7789_Clip_DrawPixel(cx + y, cy + x, color);
+    ST7789_Clip_DrawPixel(cx - y, cy + x, color);
+    ST7789_Clip_DrawPixel(cx - x, cy + y, color);
+    ST7789_Clip_DrawPixel(cx - x, cy - y, color);
+    ST7789_Clip_DrawPixel(cx - y, cy - x, color);
+    ST7789_Clip_DrawPixel(cx + y, cy - x, color);
+    ST7789_Clip_DrawPixel(cx + x, cy - y, color);
+    y++;
+    if (err < 0) {
+      err += 2 * y + 1;
+    } else {
+      x--;
+      err += 2 * (y - x) + 1;
+    }
+  }
+}
+
+typedef struct {
+  const uint16_t *p; // 可见子矩形第一行
+  uint16_t w;        // 图片宽度
+} clip_image_t;
+
+static const uint16_t *clip_image_row(uint16_t row, uint16_t *line, void *ctx) {
+  const clip_image_t *j = ctx;
+
+  return j->p + (uint32_t)row * j->w;
+}
+
+/**
+ * @brief 绘制图片的可见子矩形
+ * @note 可见部分与图片等宽时各行在内存中连续,一次发送;否则逐行从图片中直接DMA发送,
+ *       发送一行的同时计算下一行的地址
+ */
+void ST7789_Clip_DrawImage(int16_t x, int16_t y, uint16_t w, uint16_t h, const uint16_t *data) {
+  clip_rect_t r;
+
+  if (w == 0 || h == 0 || !clip_rect(x, y, (int32_t)x + w - 1, (int32_t)y + h - 1, &r)) {
+    return;
+  }
+  uint16_t vw = r.x1 - r.x0 + 1, vh = r.y1 - r.y0 + 1;
+  const uint16_t *p = data + (uint32_t)(r.y0 - (y + clip_cur->oy)) * w + (r.x0 - (x + clip_cur->ox));
+
+  if (vw == w) {
+    ST7789_SetAddressWindow(r.x0, r.y0, r.x1, r.y1);
+    st7789_write_data_buf((const uint8_t *)p, (uint32_t)vw * vh * 2);
+    return;
+  }
+  clip_image_t j = {p, w};
+  st7789_stream_rows(r.x0, r.y0, r.x1, r.y1, clip_image_row, &j);
+}
+
+// my_st7789_2.h中的基本图形函数
+
+/**
+ * @brief 画点
+ * @param color RGB565颜色
+ * @note 点先进入写合并缓冲,不一定立即出现在屏幕上,需要时调用ST7789_Flush
+ */
+void ST7789_DrawPixel(uint16_t x, uint16_t y, uint16_t color) {
+  ST7789_Clip_DrawPixel(x, y, color);
+}
+
+void ST7789_Fill(uint16_t xSta, uint16_t ySta, uint16_t xEnd, uint16_t yEnd, uint16_t color) {
+  ST7789_PROF_BEGIN();
+  ST7789_Clip_Fill(xSta, ySta, xEnd, yEnd, color);
+  ST7789_PROF_END(ST7789_PROF_FILL);
+}
+
+void ST7789_DrawLine(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color) {
+  ST7789_Clip_DrawLine(x1, y1, x2, y2, color);
+}
+
+void ST7789_DrawRectangle(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color) {
+  ST7789_Clip_DrawRect(x1, y1, x2, y2, color);
+}
+
+void ST7789_DrawCircle(uint16_t x0, uint16_t y0, uint8_t r, uint16_t color) {
+  ST7789_Clip_DrawCircle(x0, y0, r, color);
+}
+
+/**
+ * @param data 面板字节序的像素数据,w*h
+ */
+void ST7789_DrawImage(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t *data) {
+  ST7789_PROF_BEGIN();
+  ST7789_Clip_DrawImage(x, y, w, h, data);
+  ST7789_PROF_END(ST7789_PROF_DRAW_IMAGE);
+}
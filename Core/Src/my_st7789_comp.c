@@ -0,0 +1,369 @@
+/**
+ * @name         : my_st7789_comp.c
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-20 03:36:12
+ * @brief        : ST7789 多层行合成实现
+ * 每行先求出各层在窗口内实际覆盖的列范围,没有层覆盖的部分是底色;
+ * 只有一层且为不透明图片,覆盖整行时直接发送图片行,否则从下到上逐层写入行缓冲:
+ * 不透明的连续像素直接复制,半透明的先用ST7789_Swap16转成本机字节序,再用ST7789_Blend565混合
+ * @version      : V1.4
+ * V1.1 2026-10-20 07:40:12 逐行发送改用st7789_stream_rows
+ * V1.2 2026-10-20 08:02:36 临时行缓冲改为合成期间从内存池借用
+ * V1.3 2026-10-20 08:41:09 加入性能统计
+ * V1.4 2026-10-20 09:41:36 底色由M2M DMA在后台填充,与第一层源像素的生成重叠
+ */
+
+#include "my_st7789_comp.h"
+#include "my_st7789_kern.h"
+#include "my_st7789_ll.h"
+#include "my_st7789_m2m.h"
+#include "my_st7789_prof.h"
+#include <string.h>
+
+typedef struct {
+  int16_t x0, y0, x1, y1; // 闭区间
+} comp_rect_t;
+
+static ST7789_Layer *comp_layers[ST7789_COMP_LAYERS];
+static uint16_t comp_base; // 面板字节序
+
+static uint16_t *comp_src; // 纯色,着色器层的像素和混合时的临时缓冲,合成期间从"line"内存池借用
+static uint16_t *comp_fill_dst; // 正在由M2M DMA填充底色的行,写入前必须comp_sync
+static uint16_t comp_fill_n;
+
+static void comp_layer_init(ST7789_Layer *l, int16_t x, int16_t y, uint16_t w, uint16_t h, uint8_t source) {
+  memset(l, 0, sizeof(*l));
+  l->x = x;
+  l->y = y;
+  l->w = w;
+  l->h = h;
+  l->source = source;
+  l->flags = ST7789_LAYER_VISIBLE;
+  l->alpha = 32;
+}
+
+void ST7789_Layer_InitFill(ST7789_Layer *l, int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t color) {
+  comp_layer_init(l, x, y, w, h, ST7789_LAYER_SRC_FILL);
+  l->color = ST7789_SWAP16(color);
+}
+
+/**
+ * @param image 像素数据,面板字节序
+ */
+void ST7789_Layer_InitImage(ST7789_Layer *l, int16_t x, int16_t y, uint16_t w, uint16_t h, const uint16_t *image) {
+  comp_layer_init(l, x, y, w, h, ST7789_LAYER_SRC_IMAGE);
+  l->image = image;
+}
+
+void ST7789_Layer_InitShader(ST7789_Layer *l, int16_t x, int16_t y, uint16_t w, uint16_t h, ST7789_ShaderFunc fn,
+                             void *ctx) {
+  comp_layer_init(l, x, y, w, h, ST7789_LAYER_SRC_SHADER);
+  l->shader = fn;
+  l->ctx = ctx;
+}
+
+void ST7789_Layer_InitMask(ST7789_Layer *l, int16_t x, int16_t y, uint16_t w, uint16_t h, const uint8_t *mask,
+                           uint16_t color) {
+  comp_layer_init(l, x, y, w, h, ST7789_LAYER_SRC_MASK);
+  l->mask = mask;
+  l->color = ST7789_SWAP16(color);
+}
+
+/**
+ * @param key RGB565色键
+ */
+void ST7789_Layer_SetColorKey(ST7789_Layer *l, uint16_t key) {
+  l->key = ST7789_SWAP16(key);
+  l->flags |= ST7789_LAYER_COLORKEY;
+}
+
+void ST7789_Layer_SetAlpha(ST7789_Layer *l, uint8_t alpha) {
+  l->alpha = alpha > 32 ? 32 : alpha;
+}
+
+/**
+ * @brief 层内第row行第u列是否不透明(只看色键和位图)
+ */
+static uint8_t comp_opaque_at(const ST7789_Layer *l, uint16_t row, uint16_t u) {
+  if (l->source == ST7789_LAYER_SRC_MASK) {
+    return (l->mask[(uint32_t)row * ((l->w + 7) / 8) + (u >> 3)] & (0x80 >> (u & 7))) != 0;
+  }
+  return l->image[(uint32_t)row * l->w + u] != l->key;
+}
+
+uint16_t ST7789_Layer_BuildCoverage(ST7789_Layer *l, ST7789_RowSpan *spans) {
+  uint16_t rows = 0;
+
+  if (l->source != ST7789_LAYER_SRC_IMAGE && l->source != ST7789_LAYER_SRC_MASK) {
+    return 0;
+  }
+  uint8_t keyed = l->source == ST7789_LAYER_SRC_MASK || (l->flags & ST7789_LAYER_COLORKEY);
+  for (uint16_t r = 0; r < l->h; r++) {
+    uint16_t a = 0, b = l->w;
+    if (keyed) {
+      while (a < l->w && !comp_opaque_at(l, r, a)) {
+        a++;
+      }
+      while (b > a && !comp_opaque_at(l, r, b - 1)) {
+        b--;
+      }
+    }
+    if (a < b) {
+      spans[r].x0 = a;
+      spans[r].x1 = b - 1;
+      rows++;
+    } else {
+      spans[r].x0 = 1;
+      spans[r].x1 = 0;
+    }
+  }
+  l->cover = spans;
+  return rows;
+}
+
+HAL_StatusTypeDef ST7789_Comp_SetLayer(uint8_t index, ST7789_Layer *l) {
+  if (index >= ST7789_COMP_LAYERS) {
+    return HAL_ERROR;
+  }
+  comp_layers[index] = l;
+  return HAL_OK;
+}
+
+void ST7789_Comp_SetBase(uint16_t color) {
+  comp_base = ST7789_SWAP16(color);
+}
+
+/**
+ * @brief 层在第y行x0~x1范围内覆盖的屏幕列
+ * @return 0: 该行不涉及这一层
+ */
+static uint8_t comp_span(const ST7789_Layer *l, int16_t y, int16_t x0, int16_t x1, int16_t *sx0, int16_t *sx1) {
+  if (l == NULL || !(l->flags & ST7789_LAYER_VISIBLE) || y < l->y || y >= l->y + (int32_t)l->h) {
+    return 0;
+  }
+  int32_t a = l->x, b = l->x + (int32_t)l->w - 1;
+  if (l->cover) {
+    const ST7789_RowSpan *c = &l->cover[y - l->y];
+    if (c->x0 > c->x1) {
+      return 0;
+    }
+    a = l->x + c->x0;
+    b = l->x + c->x1;
+  }
+  if (a < x0) {
+    a = x0;
+  }
+  if (b > x1) {
+    b = x1;
+  }
+  if (a > b) {
+    return 0;
+  }
+  *sx0 = a;
+  *sx1 = b;
+  return 1;
+}
+
+static uint8_t comp_is_opaque(const ST7789_Layer *l) {
+  return l->alpha >= 32 && l->source != ST7789_LAYER_SRC_MASK && !(l->flags & ST7789_LAYER_COLORKEY);
+}
+
+/**
+ * @brief 把n个像素写到dst
+ * @param tmp 与src对应的临时缓冲(可以就是src),半透明时用于转换字节序
+ */
+static void comp_put(uint16_t *dst, const uint16_t *src, uint16_t *tmp, uint16_t n, uint8_t alpha) {
+  if (alpha >= 32) {
+    memcpy(dst, src, (uint32_t)n * 2);
+  } else if (alpha > 0) {
+    ST7789_Swap16(tmp, src, n);
+    ST7789_Swap16(dst, dst, n);
+    ST7789_Blend565(dst, tmp, n, alpha);
+    ST7789_Swap16(dst, dst, n);
+  }
+}
+
+/**
+ * @brief 等待后台的底色填充结束;DMA出错时改由CPU填充
+ */
+static void comp_sync(void) {
+  if (comp_fill_dst != NULL) {
+    if (ST7789_M2M_Wait() != HAL_OK) {
+      ST7789_Memset16(comp_fill_dst, comp_base, comp_fill_n);
+    }
+    comp_fill_dst = NULL;
+  }
+}
+
+/**
+ * @brief 把一层在屏幕列sx0~sx1的像素叠加到dst(对应sx0)
+ * @note 先准备源像素(着色器,纯色),再等待底色填充,两者在时间上重叠
+ */
+static void comp_layer_row(const ST7789_Layer *l, int16_t y, int16_t sx0, int16_t sx1, uint16_t *dst) {
+  uint16_t n = sx1 - sx0 + 1, u0 = sx0 - l->x, row = y - l->y;
+  const uint16_t *src = comp_src;
+
+  switch (l->source) {
+  case ST7789_LAYER_SRC_IMAGE:
+    src = l->image + (uint32_t)row * l->w + u0;
+    break;
+  case ST7789_LAYER_SRC_SHADER:
+    l->shader(y, sx0, sx1, comp_src, l->ctx);
+    break;
+  default:
+    ST7789_Memset16(comp_src, l->color, n);
+    break;
+  }
+  comp_sync();
+
+  if (l->source != ST7789_LAYER_SRC_MASK && !(l->flags & ST7789_LAYER_COLORKEY)) {
+    comp_put(dst, src, comp_src, n, l->alpha);
+    return;
+  }
+  /* 按连续的不透明像素分段写入 */
+  for (uint16_t i = 0; i < n;) {
+    while (i < n && !(l->source == ST7789_LAYER_SRC_MASK ? comp_opaque_at(l, row, u0 + i) : src[i] != l->key)) {
+      i++;
+    }
+    uint16_t s = i;
+    while (i < n && (l->source == ST7789_LAYER_SRC_MASK ? comp_opaque_at(l, row, u0 + i) : src[i] != l->key)) {
+      i++;
+    }
+    if (i > s) {
+      comp_put(dst + s, src + s, comp_src + s, i - s, l->alpha);
+    }
+  }
+}
+
+/**
+ * @brief 合成第y行
+ * @return 可以直接发送的图片行,NULL表示结果在out中
+ */
+static const uint16_t *comp_row(int16_t y, int16_t x0, int16_t x1, uint16_t *out) {
+  int16_t sx0[ST7789_COMP_LAYERS], sx1[ST7789_COMP_LAYERS];
+  uint8_t hit[ST7789_COMP_LAYERS];
+  uint8_t count = 0, top = 0;
+
+  for (uint8_t i = 0; i < ST7789_COMP_LAYERS; i++) {
+    hit[i] = comp_span(comp_layers[i], y, x0, x1, &sx0[i], &sx1[i]);
+    if (hit[i]) {
+      count++;
+      top = i;
+    }
+  }
+
+  const ST7789_Layer *l = comp_layers[top];
+  if (count == 1 && l->source == ST7789_LAYER_SRC_IMAGE && comp_is_opaque(l) && sx0[top] == x0 && sx1[top] == x1) {
+    return l->image + (uint32_t)(y - l->y) * l->w + (x0 - l->x); // 直通
+  }
+
+  uint8_t first = 0;
+  while (first < ST7789_COMP_LAYERS && !hit[first]) {
+    first++;
+  }
+  if (first == ST7789_COMP_LAYERS || !comp_is_opaque(comp_layers[first]) || sx0[first] != x0 || sx1[first] != x1) {
+    comp_fill_n = x1 - x0 + 1;
+    comp_fill_dst = out;
+    ST7789_M2M_Fill16(out, comp_base, comp_fill_n); // 后台填充,第一层的源像素同时由CPU生成
+  }
+  for (uint8_t i = first; i < ST7789_COMP_LAYERS; i++) {
+    if (hit[i]) {
+      comp_layer_row(comp_layers[i], y, sx0[i], sx1[i], out + (sx0[i] - x0));
+    }
+  }
+  comp_sync();
+  return NULL;
+}
+
+typedef struct {
+  uint16_t x0, x1, y0;
+} comp_job_t;
+
+static const uint16_t *comp_stream_row(uint16_t row, uint16_t *line, void *ctx) {
+  const comp_job_t *j = ctx;
+  const uint16_t *p = comp_row(j->y0 + row, j->x0, j->x1, line);
+
+  return p ? p : line;
+}
+
+/**
+ * @brief 合成并发送一个屏幕窗口
+ * @note 整个窗口只设置一次地址窗口;直通的行直接返回图片行,不占用行缓冲
+ */
+void ST7789_Comp_Render(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
+  if (x1 >= ST7789_WIDTH) {
+    x1 = ST7789_WIDTH - 1;
+  }
+  if (y1 >= ST7789_HEIGHT) {
+    y1 = ST7789_HEIGHT - 1;
+  }
+  if (x0 > x1 || y0 > y1) {
+    return;
+  }
+
+  ST7789_PROF_BEGIN();
+  comp_src = st7789_line_alloc();
+  if (comp_src != NULL) {
+    comp_job_t j = {x0, x1, y0};
+    st7789_stream_rows(x0, y0, x1, y1, comp_stream_row, &j);
+    st7789_line_free(comp_src);
+    comp_src = NULL;
+  }
+  ST7789_PROF_END(ST7789_PROF_COMP_RENDER);
+}
+
+/**
+ * @brief 计算层在(x,y)处的包围盒并裁剪到屏幕
+ */
+static uint8_t comp_get_rect(const ST7789_Layer *l, int16_t x, int16_t y, comp_rect_t *r) {
+  int32_t x0 = x, y0 = y;
+  int32_t x1 = x0 + l->w - 1, y1 = y0 + l->h - 1;
+
+  if (x0 < 0) x0 = 0;
+  if (y0 < 0) y0 = 0;
+  if (x1 > ST7789_WIDTH - 1) x1 = ST7789_WIDTH - 1;
+  if (y1 > ST7789_HEIGHT - 1) y1 = ST7789_HEIGHT - 1;
+  if (x0 > x1 || y0 > y1) {
+    return 0;
+  }
+  r->x0 = x0;
+  r->y0 = y0;
+  r->x1 = x1;
+  r->y1 = y1;
+  return 1;
+}
+
+static uint32_t comp_rect_area(const comp_rect_t *r) {
+  return (uint32_t)(r->x1 - r->x0 + 1) * (uint32_t)(r->y1 - r->y0 + 1);
+}
+
+/**
+ * @brief 移动层并重新合成新旧包围盒
+ * @note 与精灵层相同:并集面积不超过二者面积之和时合成一个窗口,否则分别合成
+ */
+void ST7789_Comp_Move(ST7789_Layer *l, int16_t x, int16_t y) {
+  comp_rect_t old_r, new_r;
+  uint8_t has_old = (l->flags & ST7789_LAYER_VISIBLE) && comp_get_rect(l, l->x, l->y, &old_r);
+
+  l->x = x;
+  l->y = y;
+  uint8_t has_new = (l->flags & ST7789_LAYER_VISIBLE) && comp_get_rect(l, x, y, &new_r);
+
+  if (has_old && has_new) {
+    comp_rect_t u;
+    u.x0 = old_r.x0 < new_r.x0 ? old_r.x0 : new_r.x0;
+    u.y0 = old_r.y0 < new_r.y0 ? old_r.y0 : new_r.y0;
+    u.x1 = old_r.x1 > new_r.x1 ? old_r.x1 : new_r.x1;
+    u.y1 = old_r.y1 > new_r.y1 ? old_r.y1 : new_r.y1;
+    if (comp_rect_area(&u) <= comp_rect_area(&old_r) + comp_rect_area(&new_r)) {
+      ST7789_Comp_Render(u.x0, u.y0, u.x1, u.y1);
+      return;
+    }
+  }
+  if (has_old) {
+    ST7789_Comp_Render(old_r.x0, old_r.y0, old_r.x1, old_r.y1);
+  }
+  if (has_new) {
+    ST7789_Comp_Render(new_r.x0, new_r.y0, new_r.x1, new_r.y1);
+  }
+}
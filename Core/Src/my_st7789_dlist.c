@@ -0,0 +1,351 @@
+/**
+ * @name         : my_st7789_dlist.c
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-19 11:20:07
+ * @brief        : ST7789 显示列表实现
+ * 回放时每个操作转换为一个传输引擎事务,事务完成回调中再把后续操作送入队列,
+ * 各阶段的DC切换和DMA启动都由传输引擎在中断中完成,主循环提交后即可返回
+ * @version      : V1.3
+ * V1.1 2026-10-19 13:05:32 回放状态机移入传输引擎(my_st7789_xfer)
+ * V1.2 2026-10-19 18:10:42 等待回放时WFI睡眠,提交时唤醒面板
+ * V1.3 2026-10-20 10:24:48 传输队列被占满时提交等待空位,等待和查询时重试送入剩余操作
+ */
+
+#include "my_st7789_dlist.h"
+#include "my_st7789_ll.h"
+#include "my_st7789_xfer.h"
+#include "my_st7789_prof.h"
+
+#define DL_OP_FILL  0
+#define DL_OP_IMAGE 1
+
+typedef struct {
+  uint8_t type;
+  uint16_t x0, y0, x1, y1; // 闭区间
+  union {
+    uint16_t color;        // RGB565
+    const uint16_t *data;
+  } u;
+} dlist_op_t;
+
+static dlist_op_t dlist_buf[2][ST7789_DLIST_MAX_OPS];
+static uint8_t dlist_count[2];
+static uint8_t rec_idx; // 正在记录的列表
+
+/* 回放状态,只在事务完成回调和提交时修改 */
+static volatile uint8_t dlist_busy;
+static uint8_t play_idx;
+static uint8_t play_queued; // 已送入传输队列的操作数
+static uint8_t play_done;   // 已完成的操作数
+
+static uint8_t dlist_contains(const dlist_op_t *outer, const dlist_op_t *inner) {
+  return inner->x0 >= outer->x0 && inner->x1 <= outer->x1 &&
+         inner->y0 >= outer->y0 && inner->y1 <= outer->y1;
+}
+
+static uint8_t dlist_overlap(const dlist_op_t *a, const dlist_op_t *b) {
+  return a->x0 <= b->x1 && b->x0 <= a->x1 && a->y0 <= b->y1 && b->y0 <= a->y1;
+}
+
+/**
+ * @brief 两个同色填充能否合并成一个矩形
+ * @note 只用于列表中相邻的两个操作,合并不会改变绘制结果
+ */
+static uint8_t dlist_try_merge(dlist_op_t *a, const dlist_op_t *b) {
+  if (a->type != DL_OP_FILL || b->type != DL_OP_FILL || a->u.color != b->u.color) {
+    return 0;
+  }
+  if (a->x0 == b->x0 && a->x1 == b->x1 && (a->y1 + 1 == b->y0 || b->y1 + 1 == a->y0)) {
+    a->y0 = a->y0 < b->y0 ? a->y0 : b->y0;
+    a->y1 = a->y1 > b->y1 ? a->y1 : b->y1;
+    return 1;
+  }
+  if (a->y0 == b->y0 && a->y1 == b->y1 && (a->x1 + 1 == b->x0 || b->x1 + 1 == a->x0)) {
+    a->x0 = a->x0 < b->x0 ? a->x0 : b->x0;
+    a->x1 = a->x1 > b->x1 ? a->x1 : b->x1;
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * @brief 追加一个操作
+ * @note 新操作完全覆盖的旧操作不会被看到,直接删除;与上一个操作同色相邻时合并
+ */
+static void dlist_push(const dlist_op_t *op) {
+  dlist_op_t *list = dlist_buf[rec_idx];
+  uint8_t n = dlist_count[rec_idx];
+  uint8_t k = 0;
+
+  for (uint8_t i = 0; i < n; i++) {
+    if (!dlist_contains(op, &list[i])) {
+      list[k++] = list[i];
+    }
+  }
+  n = k;
+
+  if (n > 0 && dlist_try_merge(&list[n - 1], op)) {
+    dlist_count[rec_idx] = n;
+    return;
+  }
+
+  if (n >= ST7789_DLIST_MAX_OPS) {
+    dlist_count[rec_idx] = n;
+    ST7789_DList_Submit();
+    list = dlist_buf[rec_idx];
+    n = 0;
+  }
+  list[n++] = *op;
+  dlist_count[rec_idx] = n;
+}
+
+/**
+ * @brief 提交前整理列表
+ * @note 按(y0,x0)做插入排序,只交换互不重叠的相邻操作,因此绘制结果不变;
+ *       排序后同色相邻的填充有机会合并,同一行带的操作也排在一起
+ */
+static void dlist_optimize(dlist_op_t *list, uint8_t *count) {
+  uint8_t n = *count;
+
+  for (uint8_t i = 1; i < n; i++) {
+    for (uint8_t j = i; j > 0; j--) {
+      dlist_op_t *a = &list[j - 1], *b = &list[j];
+      uint8_t after = a->y0 > b->y0 || (a->y0 == b->y0 && a->x0 > b->x0);
+      if (!after || dlist_overlap(a, b)) {
+        break;
+      }
+      dlist_op_t t = *a;
+      *a = *b;
+      *b = t;
+    }
+  }
+
+  uint8_t k = 0;
+  for (uint8_t i = 0; i < n; i++) {
+    if (k > 0 && dlist_try_merge(&list[k - 1], &list[i])) {
+      continue;
+    }
+    list[k++] = list[i];
+  }
+  *count = k;
+}
+
+static void dlist_op_done(void *ctx);
+
+/**
+ * @brief 把回放列表中的操作送入传输队列,直到队列满或全部送完
+ */
+static void dlist_feed(void) {
+  while (play_queued < dlist_count[play_idx]) {
+    const dlist_op_t *op = &dlist_buf[play_idx][play_queued];
+    ST7789_Xfer x = {
+        .x0 = op->x0,
+        .y0 = op->y0,
+        .x1 = op->x1,
+        .y1 = op->y1,
+        .count = (uint32_t)(op->x1 - op->x0 + 1) * (op->y1 - op->y0 + 1),
+        .done = dlist_op_done,
+    };
+    if (op->type == DL_OP_IMAGE) {
+      x.mode = ST7789_XFER_COPY;
+      x.src = op->u.data;
+    } else {
+      x.mode = ST7789_XFER_REPEAT;
+      x.color = op->u.color;
+    }
+    if (ST7789_Xfer_Submit(&x) != HAL_OK) {
+      break;
+    }
+    play_queued++;
+  }
+}
+
+/**
+ * @brief 回放中还有操作没有送入传输队列时再送一次
+ * @note 传输队列被其他模块占满时dlist_feed可能一个也送不进去,之后没有完成回调接着送,
+ *       由这里在等待和查询时重试
+ */
+static void dlist_retry(void) {
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  if (dlist_busy && play_queued < dlist_count[play_idx]) {
+    dlist_feed();
+  }
+  __set_PRIMASK(primask);
+}
+
+/**
+ * @brief 单个操作回放完成,在DMA中断中调用
+ */
+static void dlist_op_done(void *ctx) {
+  (void)ctx;
+  play_done++;
+  if (play_done >= dlist_count[play_idx]) {
+    dlist_busy = 0;
+  } else {
+    dlist_feed();
+  }
+}
+
+/**
+ * @brief 开始记录新的一帧,丢弃尚未提交的记录
+ */
+void ST7789_DList_Begin(void) {
+  dlist_count[rec_idx] = 0;
+}
+
+/**
+ * @brief 记录矩形填充
+ */
+void ST7789_DList_Fill(uint16_t xSta, uint16_t ySta, uint16_t xEnd, uint16_t yEnd, uint16_t color) {
+  if (xSta > xEnd || ySta > yEnd || xSta >= ST7789_WIDTH || ySta >= ST7789_HEIGHT) {
+    return;
+  }
+  dlist_op_t op = {
+      .type = DL_OP_FILL,
+      .x0 = xSta,
+      .y0 = ySta,
+      .x1 = xEnd < ST7789_WIDTH ? xEnd : ST7789_WIDTH - 1,
+      .y1 = yEnd < ST7789_HEIGHT ? yEnd : ST7789_HEIGHT - 1,
+      .u.color = color,
+  };
+  dlist_push(&op);
+}
+
+/**
+ * @brief 记录全屏填充,之前记录的所有操作都会被折叠掉
+ */
+void ST7789_DList_FillScreen(uint16_t color) {
+  ST7789_DList_Fill(0, 0, ST7789_WIDTH - 1, ST7789_HEIGHT - 1, color);
+}
+
+/**
+ * @brief 记录直线
+ * @note 按Bresenham算法拆成水平或竖直的线段,每段记录为一个填充,
+ *       相比逐像素绘制,每段只需要一次窗口设置
+ */
+void ST7789_DList_Line(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color) {
+  int16_t dx = x2 > x1 ? x2 - x1 : x1 - x2;
+  int16_t dy = y2 > y1 ? y2 - y1 : y1 - y2;
+  int16_t sx = x1 < x2 ? 1 : -1;
+  int16_t sy = y1 < y2 ? 1 : -1;
+  int16_t err = dx - dy;
+  int16_t x = x1, y = y1;
+  int16_t run_x = x, run_y = y;
+
+  for (;;) {
+    uint8_t last = x == x2 && y == y2;
+    int16_t nx = x, ny = y;
+    if (!last) {
+      int16_t e2 = 2 * err;
+      if (e2 > -dy) {
+        err -= dy;
+        nx += sx;
+      }
+      if (e2 < dx) {
+        err += dx;
+        ny += sy;
+      }
+    }
+    /* 主方向为水平时y变化结束一段,主方向为竖直时x变化结束一段 */
+    if (last || (dx >= dy ? ny != y : nx != x)) {
+      ST7789_DList_Fill(run_x < x ? run_x : x, run_y < y ? run_y : y,
+                        run_x > x ? run_x : x, run_y > y ? run_y : y, color);
+      run_x = nx;
+      run_y = ny;
+    }
+    if (last) {
+      break;
+    }
+    x = nx;
+    y = ny;
+  }
+}
+
+/**
+ * @brief 记录矩形边框
+ */
+void ST7789_DList_Rect(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color) {
+  ST7789_DList_Fill(x1, y1, x2, y1, color);
+  ST7789_DList_Fill(x1, y2, x2, y2, color);
+  ST7789_DList_Fill(x1, y1, x1, y2, color);
+  ST7789_DList_Fill(x2, y1, x2, y2, color);
+}
+
+/**
+ * @brief 记录图片
+ * @param data 像素数据,面板字节序,回放结束前必须保持有效
+ */
+void ST7789_DList_Image(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t *data) {
+  if (w == 0 || h == 0 || x + w > ST7789_WIDTH || y + h > ST7789_HEIGHT) {
+    return;
+  }
+  dlist_op_t op = {
+      .type = DL_OP_IMAGE,
+      .x0 = x,
+      .y0 = y,
+      .x1 = x + w - 1,
+      .y1 = y + h - 1,
+      .u.data = data,
+  };
+  dlist_push(&op);
+}
+
+/**
+ * @brief 提交当前记录的帧,立即返回
+ * @note 如果上一帧还在回放,会等待其结束后再启动本帧
+ */
+void ST7789_DList_Submit(void) {
+  uint8_t idx = rec_idx;
+
+  if (dlist_count[idx] == 0) {
+    return;
+  }
+  ST7789_PROF_BEGIN();
+  st7789_pixel_flush();
+  st7789_pm_activity(); // 回放在关中断时启动,面板睡眠时需要先在这里唤醒
+  dlist_optimize(dlist_buf[idx], &dlist_count[idx]);
+
+  ST7789_DList_Wait();
+
+  rec_idx ^= 1;
+  dlist_count[rec_idx] = 0;
+
+  play_idx = idx;
+  play_queued = 0;
+  play_done = 0;
+  dlist_busy = 1;
+
+  /* 完成回调也会调用dlist_feed,关中断避免同一操作被送入两次 */
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  dlist_feed();
+  __set_PRIMASK(primask);
+
+  /* 一个操作都没送进去时不会有完成回调接着送,等其他模块的事务腾出空位 */
+  while (play_queued == 0 && __get_IPSR() == 0) {
+    while (ST7789_Xfer_IsBusy()) {
+      ST7789_SLEEP_WHILE(ST7789_Xfer_IsBusy());
+    }
+    dlist_retry();
+  }
+  ST7789_PROF_END(ST7789_PROF_DLIST_SUBMIT);
+}
+
+/**
+ * @brief 是否还有帧正在回放
+ */
+uint8_t ST7789_DList_IsBusy(void) {
+  dlist_retry();
+  return dlist_busy;
+}
+
+/**
+ * @brief 等待回放结束
+ */
+void ST7789_DList_Wait(void) {
+  while (dlist_busy) {
+    dlist_retry(); // 传输队列被占满时,每完成一个事务重试一次
+    ST7789_SLEEP_WHILE(dlist_busy);
+  }
+}
@@ -0,0 +1,345 @@
+/**
+ * @name         : my_st7789_fb.c
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-19 22:30:57
+ * @brief        : ST7789 索引色帧缓冲实现
+ * 行展开约每像素十个周期,72MHz下一行约35us,而18Mbit/s发送一行要213us,展开完全被发送时间掩盖
+ * 低分辨率模式每个源行发送两次,有426us的时间展开下一行
+ * @version      : V1.6
+ * V1.1 2026-10-19 23:12:40 增加8bpp和120x120像素倍增的低分辨率模式
+ * V1.2 2026-10-20 00:25:36 全分辨率4/8bpp行展开改用像素内核
+ * V1.3 2026-10-20 01:02:47 行展开放入SRAM运行
+ * V1.4 2026-10-20 07:40:12 逐行发送改用st7789_stream_rows
+ * V1.5 2026-10-20 08:41:09 加入性能统计
+ * V1.6 2026-10-20 12:10:33 初始化之前调用ST7789_FB_MarkDirty,Clear,SetPalette和矩形操作时直接返回
+ */
+
+#include "my_st7789_fb.h"
+#include "my_st7789_kern.h"
+#include "my_st7789_ll.h"
+#include "my_st7789_prof.h"
+#include <string.h>
+
+static uint8_t *fb_mem;
+static uint8_t fb_bpp;
+static uint8_t fb_scale;                               // 1或2,每个逻辑像素在屏幕上的边长
+static uint16_t fb_w, fb_h;                            // 逻辑尺寸
+static uint16_t fb_stride;
+static uint16_t fb_palette[256];                       // 面板字节序
+static uint32_t fb_dirty[(ST7789_HEIGHT + 31) / 32];   // 每行一位
+
+#define fb_mark(y)     (fb_dirty[(y) >> 5] |= 1u << ((y) & 31))
+#define fb_is_dirty(y) (fb_dirty[(y) >> 5] & (1u << ((y) & 31)))
+
+/**
+ * @brief 把索引值复制到一个字节中的每个像素
+ */
+static uint8_t fb_pattern(uint8_t index) {
+  index &= (1u << fb_bpp) - 1;
+  switch (fb_bpp) {
+  case 1:
+    return index ? 0xFF : 0x00;
+  case 2:
+    return index * 0x55;
+  case 4:
+    return index * 0x11;
+  default:
+    return index;
+  }
+}
+
+/**
+ * @brief 对一行中[x0,x1]的像素做 覆盖(xor=0) 或 异或(xor=1)
+ * @note 首尾不满一字节的像素逐个处理,中间整字节一次处理
+ */
+static void fb_row_op(uint8_t *row, uint16_t x0, uint16_t x1, uint8_t pattern, uint8_t xor) {
+  uint8_t ppb = 8 / fb_bpp; // 每字节像素数
+  uint16_t x = x0;
+
+  while (x <= x1 && (x % ppb) != 0) {
+    uint8_t shift = 8 - fb_bpp - (x % ppb) * fb_bpp;
+    uint8_t mask = ((1u << fb_bpp) - 1) << shift;
+    uint8_t *p = &row[x / ppb];
+    *p = xor ? (*p ^ (pattern & mask)) : ((*p & ~mask) | (pattern & mask));
+    x++;
+  }
+  uint16_t bytes = (x1 + 1 - x) / ppb;
+  if (x <= x1 && bytes > 0) {
+    uint8_t *p = &row[x / ppb];
+    if (xor) {
+      for (uint16_t i = 0; i < bytes; i++) {
+        p[i] ^= pattern;
+      }
+    } else {
+      memset(p, pattern, bytes);
+    }
+    x += bytes * ppb;
+  }
+  while (x <= x1) {
+    uint8_t shift = 8 - fb_bpp - (x % ppb) * fb_bpp;
+    uint8_t mask = ((1u << fb_bpp) - 1) << shift;
+    uint8_t *p = &row[x / ppb];
+    *p = xor ? (*p ^ (pattern & mask)) : ((*p & ~mask) | (pattern & mask));
+    x++;
+  }
+}
+
+/* 输出一个展开后的像素,低分辨率模式输出两次 */
+#define FB_EMIT(c)                 \
+  do {                             \
+    uint16_t c_ = (c);             \
+    *out++ = c_;                   \
+    if (dbl) {                     \
+      *out++ = c_;                 \
+    }                              \
+  } while (0)
+
+/**
+ * @brief 经调色板把一行展开成面板字节序的RGB565,低分辨率模式同时水平放大2倍
+ */
+static ST7789_RAMFUNC void fb_expand_row(uint16_t y, uint16_t *out) {
+  const uint8_t *row = fb_mem + (uint32_t)y * fb_stride;
+  const uint8_t dbl = fb_scale == 2;
+
+  if (!dbl && fb_bpp >= 4) {
+    if (fb_bpp == 8) {
+      ST7789_Expand8(out, row, fb_w, fb_palette);
+    } else {
+      ST7789_Expand4(out, row, fb_w, fb_palette);
+    }
+    return;
+  }
+  switch (fb_bpp) {
+  case 1: {
+    uint16_t c0 = fb_palette[0], c1 = fb_palette[1];
+    for (uint16_t i = 0; i < fb_stride; i++) {
+      uint8_t b = row[i];
+      for (uint8_t k = 0; k < 8; k++, b <<= 1) {
+        FB_EMIT((b & 0x80) ? c1 : c0);
+      }
+    }
+    break;
+  }
+  case 2:
+    for (uint16_t i = 0; i < fb_stride; i++) {
+      uint8_t b = row[i];
+      FB_EMIT(fb_palette[b >> 6]);
+      FB_EMIT(fb_palette[(b >> 4) & 3]);
+      FB_EMIT(fb_palette[(b >> 2) & 3]);
+      FB_EMIT(fb_palette[b & 3]);
+    }
+    break;
+  case 4:
+    for (uint16_t i = 0; i < fb_stride; i++) {
+      uint8_t b = row[i];
+      FB_EMIT(fb_palette[b >> 4]);
+      FB_EMIT(fb_palette[b & 0x0F]);
+    }
+    break;
+  default:
+    for (uint16_t i = 0; i < fb_stride; i++) {
+      FB_EMIT(fb_palette[row[i]]);
+    }
+    break;
+  }
+}
+
+/**
+ * @brief 初始化帧缓冲的公共部分
+ */
+static HAL_StatusTypeDef fb_init(uint8_t bpp, uint8_t scale, uint8_t *mem, uint32_t size) {
+  uint16_t w = ST7789_WIDTH / scale, h = ST7789_HEIGHT / scale;
+  uint32_t stride = ((uint32_t)w * bpp + 7) / 8;
+
+  if ((bpp != 1 && bpp != 2 && bpp != 4 && bpp != 8) || (w * bpp) % 8 != 0 || mem == NULL ||
+      size < stride * h) {
+    return HAL_ERROR;
+  }
+  fb_mem = mem;
+  fb_bpp = bpp;
+  fb_scale = scale;
+  fb_w = w;
+  fb_h = h;
+  fb_stride = stride;
+
+  uint16_t n = 1u << bpp;
+  for (uint16_t i = 0; i < n; i++) {
+    uint16_t c;
+    if (bpp == 8) {
+      c = ((i >> 5) * 31 / 7) << 11 | ((i >> 2 & 7) * 63 / 7) << 5 | (i & 3) * 31 / 3; // RGB332
+    } else {
+      uint16_t v = i * 31 / (n - 1); // 5位灰度
+      c = (v << 11) | (v << 6) | v;
+    }
+    fb_palette[i] = ST7789_SWAP16(c);
+  }
+  ST7789_FB_Clear(0);
+  return HAL_OK;
+}
+
+/**
+ * @brief 初始化全分辨率帧缓冲,内容清为索引0,使用默认调色板
+ * @param bpp 1,2,4或8
+ * @param mem 帧缓冲内存,至少ST7789_FB_SIZE(bpp)字节
+ * @retval HAL_ERROR bpp不支持,或内存不足,或屏幕宽度不是整字节
+ */
+HAL_StatusTypeDef ST7789_FB_Init(uint8_t bpp, uint8_t *mem, uint32_t size) {
+  return fb_init(bpp, 1, mem, size);
+}
+
+/**
+ * @brief 初始化低分辨率帧缓冲,逻辑尺寸为屏幕的一半,刷新时放大2倍
+ * @param mem 帧缓冲内存,至少ST7789_FB_2X_SIZE(bpp)字节
+ */
+HAL_StatusTypeDef ST7789_FB_Init2x(uint8_t bpp, uint8_t *mem, uint32_t size) {
+  return fb_init(bpp, 2, mem, size);
+}
+
+/**
+ * @brief 设置调色板,全屏标记为脏
+ * @param colors RGB565颜色,按索引排列
+ */
+void ST7789_FB_SetPalette(const uint16_t *colors, uint16_t n) {
+  if (n > (1u << fb_bpp)) {
+    n = 1u << fb_bpp;
+  }
+  for (uint16_t i = 0; i < n; i++) {
+    fb_palette[i] = ST7789_SWAP16(colors[i]);
+  }
+  ST7789_FB_MarkDirty(0, fb_h - 1);
+}
+
+uint16_t ST7789_FB_Width(void) {
+  return fb_w;
+}
+
+uint16_t ST7789_FB_Height(void) {
+  return fb_h;
+}
+
+void ST7789_FB_Clear(uint8_t index) {
+  if (fb_mem == NULL) {
+    return;
+  }
+  memset(fb_mem, fb_pattern(index), (uint32_t)fb_stride * fb_h);
+  ST7789_FB_MarkDirty(0, fb_h - 1);
+}
+
+void ST7789_FB_SetPixel(uint16_t x, uint16_t y, uint8_t index) {
+  if (x >= fb_w || y >= fb_h) {
+    return;
+  }
+  fb_row_op(fb_mem + (uint32_t)y * fb_stride, x, x, fb_pattern(index), 0);
+  fb_mark(y);
+}
+
+/**
+ * @brief 读回像素的索引值
+ */
+uint8_t ST7789_FB_GetPixel(uint16_t x, uint16_t y) {
+  if (x >= fb_w || y >= fb_h) {
+    return 0;
+  }
+  uint8_t ppb = 8 / fb_bpp;
+  uint8_t shift = 8 - fb_bpp - (x % ppb) * fb_bpp;
+  return (fb_mem[(uint32_t)y * fb_stride + x / ppb] >> shift) & ((1u << fb_bpp) - 1);
+}
+
+/**
+ * @brief 像素索引值与mask异或,再做一次即恢复,适合光标
+ */
+void ST7789_FB_XorPixel(uint16_t x, uint16_t y, uint8_t mask) {
+  if (x >= fb_w || y >= fb_h) {
+    return;
+  }
+  fb_row_op(fb_mem + (uint32_t)y * fb_stride, x, x, fb_pattern(mask), 1);
+  fb_mark(y);
+}
+
+/**
+ * @brief 对闭区间矩形做覆盖或异或,超出屏幕的部分裁掉
+ */
+static void fb_rect_op(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t pattern, uint8_t xor) {
+  if (fb_w == 0 || fb_h == 0) {
+    return; // 还没有ST7789_FB_Init
+  }
+  if (x1 >= fb_w) x1 = fb_w - 1;
+  if (y1 >= fb_h) y1 = fb_h - 1;
+  if (x0 > x1 || y0 > y1) {
+    return;
+  }
+  for (uint32_t y = y0; y <= y1; y++) {
+    fb_row_op(fb_mem + (uint32_t)y * fb_stride, x0, x1, pattern, xor);
+  }
+  ST7789_FB_MarkDirty(y0, y1);
+}
+
+void ST7789_FB_FillRect(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t index) {
+  fb_rect_op(x0, y0, x1, y1, fb_pattern(index), 0);
+}
+
+void ST7789_FB_XorRect(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t mask) {
+  fb_rect_op(x0, y0, x1, y1, fb_pattern(mask), 1);
+}
+
+uint8_t *ST7789_FB_Buffer(void) {
+  return fb_mem;
+}
+
+/**
+ * @brief 标记逻辑行y0~y1为脏行,下次ST7789_FB_Flush时发送
+ * @note 初始化之前调用时什么也不做
+ */
+void ST7789_FB_MarkDirty(uint16_t y0, uint16_t y1) {
+  if (fb_h == 0) {
+    return; // fb_h-1会回绕成65535,越过fb_dirty
+  }
+  if (y1 >= fb_h) {
+    y1 = fb_h - 1;
+  }
+  for (uint32_t y = y0; y <= y1; y++) { // 32位循环变量,y1为65535时也能结束
+    fb_mark(y);
+  }
+}
+
+typedef struct {
+  uint16_t y;             // 窗口第一行对应的逻辑行
+  const uint16_t *last;   // 上一次展开的行缓冲
+} fb_job_t;
+
+static const uint16_t *fb_stream_row(uint16_t row, uint16_t *line, void *ctx) {
+  fb_job_t *j = ctx;
+
+  if (row % fb_scale != 0) {
+    return j->last; // 低分辨率模式的第二行,重复发送
+  }
+  uint16_t r = j->y + row / fb_scale;
+  fb_expand_row(r, line); // 上一行仍在DMA发送中
+  fb_dirty[r >> 5] &= ~(1u << (r & 31));
+  j->last = line;
+  return line;
+}
+
+/**
+ * @brief 把脏行发送到屏幕
+ * @note 连续的脏行共用一个窗口;返回前等待最后一行发送完毕,之后可以立即使用其他接口
+ *       低分辨率模式下同一个行缓冲连续发送两次,对应屏幕上的两行
+ */
+void ST7789_FB_Flush(void) {
+  ST7789_PROF_BEGIN();
+  for (uint16_t y = 0; y < fb_h;) {
+    if (!fb_is_dirty(y)) {
+      y++;
+      continue;
+    }
+    uint16_t y1 = y;
+    while (y1 + 1 < fb_h && fb_is_dirty(y1 + 1)) {
+      y1++;
+    }
+
+    fb_job_t j = {y, NULL};
+    st7789_stream_rows(0, y * fb_scale, ST7789_WIDTH - 1, (y1 + 1) * fb_scale - 1, fb_stream_row, &j);
+    y = y1 + 1;
+  }
+  ST7789_PROF_END(ST7789_PROF_FB_FLUSH);
+}
@@ -0,0 +1,236 @@
+/**
+ * @name         : my_st7789_kern.c
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-20 00:25:36
+ * @brief        : ST7789 像素内核接口和C参考实现
+ * 汇编内核只接受按字对齐的整块数据,这里先用C处理开头不对齐的一个像素,再把整块交给汇编,
+ * 最后处理剩下的零头;两个缓冲对齐方式不同时(地址差不是4的倍数)整段使用C实现
+ * @version      : V1.1
+ * V1.1 2026-10-20 10:43:17 保存最近一次自检结果
+ */
+
+#include "my_st7789_kern.h"
+#include <string.h>
+
+#if ST7789_KERN_ASM
+/* my_st7789_kern_m3.s */
+void st7789_fill32_m3(uint32_t *dst, uint32_t v, uint32_t nwords);
+void st7789_rev16_m3(uint32_t *dst, const uint32_t *src, uint32_t nwords);
+void st7789_expand8_m3(uint32_t *dst, const uint8_t *src, uint32_t ngroups, const uint16_t *lut);
+void st7789_expand4_m3(uint32_t *dst, const uint8_t *src, uint32_t ngroups, const uint16_t *lut);
+void st7789_blend565_m3(uint32_t *dst, const uint32_t *src, uint32_t npairs, uint32_t alpha);
+
+#define kern_misaligned(p) (((uintptr_t)(p)) & 2)
+#endif
+
+// C参考实现部分
+
+static void kern_memset16_c(uint16_t *dst, uint16_t v, uint32_t n) {
+  while (n--) {
+    *dst++ = v;
+  }
+}
+
+static void kern_swap16_c(uint16_t *dst, const uint16_t *src, uint32_t n) {
+  while (n--) {
+    *dst++ = ST7789_SWAP16(*src);
+    src++;
+  }
+}
+
+static void kern_expand8_c(uint16_t *dst, const uint8_t *src, uint32_t n, const uint16_t *lut) {
+  while (n--) {
+    *dst++ = lut[*src++];
+  }
+}
+
+static void kern_expand4_c(uint16_t *dst, const uint8_t *src, uint32_t n, const uint16_t *lut) {
+  for (uint32_t i = 0; i < n; i++) {
+    uint8_t b = src[i / 2];
+    *dst++ = lut[(i & 1) ? (b & 0x0F) : (b >> 4)];
+  }
+}
+
+static void kern_blend565_c(uint16_t *dst, const uint16_t *src, uint32_t n, uint8_t alpha) {
+  while (n--) {
+    uint16_t s = *src++, d = *dst;
+    uint16_t r = (((s >> 11) * alpha + (d >> 11) * (32 - alpha)) >> 5) << 11;
+    uint16_t g = ((((s >> 5) & 0x3F) * alpha + ((d >> 5) & 0x3F) * (32 - alpha)) >> 5) << 5;
+    uint16_t b = ((s & 0x1F) * alpha + (d & 0x1F) * (32 - alpha)) >> 5;
+    *dst++ = r | g | b;
+  }
+}
+
+// 接口部分
+
+void ST7789_Memset16(uint16_t *dst, uint16_t v, uint32_t n) {
+#if ST7789_KERN_ASM
+  if (n > 0 && kern_misaligned(dst)) {
+    *dst++ = v;
+    n--;
+  }
+  if (n >= 2) {
+    st7789_fill32_m3((uint32_t *)dst, v | ((uint32_t)v << 16), n / 2);
+    dst += n & ~1u;
+  }
+  if (n & 1) {
+    *dst = v;
+  }
+#else
+  kern_memset16_c(dst, v, n);
+#endif
+}
+
+void ST7789_Swap16(uint16_t *dst, const uint16_t *src, uint32_t n) {
+#if ST7789_KERN_ASM
+  if (kern_misaligned(dst) != kern_misaligned(src)) {
+    kern_swap16_c(dst, src, n);
+    return;
+  }
+  if (n > 0 && kern_misaligned(dst)) {
+    kern_swap16_c(dst++, src++, 1);
+    n--;
+  }
+  if (n >= 2) {
+    st7789_rev16_m3((uint32_t *)dst, (const uint32_t *)src, n / 2);
+    dst += n & ~1u;
+    src += n & ~1u;
+  }
+  kern_swap16_c(dst, src, n & 1);
+#else
+  kern_swap16_c(dst, src, n);
+#endif
+}
+
+void ST7789_Expand8(uint16_t *dst, const uint8_t *src, uint32_t n, const uint16_t *lut) {
+#if ST7789_KERN_ASM
+  if (n > 0 && kern_misaligned(dst)) {
+    *dst++ = lut[*src++];
+    n--;
+  }
+  if (n >= 4) {
+    st7789_expand8_m3((uint32_t *)dst, src, n / 4, lut);
+    dst += n & ~3u;
+    src += n & ~3u;
+  }
+  kern_expand8_c(dst, src, n & 3, lut);
+#else
+  kern_expand8_c(dst, src, n, lut);
+#endif
+}
+
+void ST7789_Expand4(uint16_t *dst, const uint8_t *src, uint32_t n, const uint16_t *lut) {
+#if ST7789_KERN_ASM
+  /* 源像素按字节成对,不能像其他内核一样先单独处理一个像素 */
+  if (kern_misaligned(dst)) {
+    kern_expand4_c(dst, src, n, lut);
+    return;
+  }
+  if (n >= 4) {
+    st7789_expand4_m3((uint32_t *)dst, src, n / 4, lut);
+    dst += n & ~3u;
+    src += (n & ~3u) / 2;
+  }
+  kern_expand4_c(dst, src, n & 3, lut);
+#else
+  kern_expand4_c(dst, src, n, lut);
+#endif
+}
+
+void ST7789_Blend565(uint16_t *dst, const uint16_t *src, uint32_t n, uint8_t alpha) {
+  if (alpha > 32) {
+    alpha = 32;
+  }
+#if ST7789_KERN_ASM
+  if (kern_misaligned(dst) != kern_misaligned(src)) {
+    kern_blend565_c(dst, src, n, alpha);
+    return;
+  }
+  if (n > 0 && kern_misaligned(dst)) {
+    kern_blend565_c(dst++, src++, 1, alpha);
+    n--;
+  }
+  if (n >= 2) {
+    st7789_blend565_m3((uint32_t *)dst, (const uint32_t *)src, n / 2, alpha);
+    dst += n & ~1u;
+    src += n & ~1u;
+  }
+  kern_blend565_c(dst, src, n & 1, alpha);
+#else
+  kern_blend565_c(dst, src, n, alpha);
+#endif
+}
+
+// 自检部分
+
+#define KERN_TEST_PX 48
+
+static uint32_t kern_rand_state;
+static uint32_t kern_selftest_errors = 0xFFFFFFFFU;
+
+static uint16_t kern_rand(void) {
+  kern_rand_state = kern_rand_state * 1664525u + 1013904223u;
+  return kern_rand_state >> 16;
+}
+
+/**
+ * @brief 内核与C参考实现的结果逐像素比较,缓冲末尾多留两个像素检查越界写
+ */
+uint32_t ST7789_Kern_SelfTest(void) {
+  static uint16_t lut[256];
+  uint16_t src[KERN_TEST_PX + 2], a[KERN_TEST_PX + 2], b[KERN_TEST_PX + 2];
+  uint8_t idx[KERN_TEST_PX];
+  uint32_t errors = 0;
+
+  kern_rand_state = 0x7789;
+  for (uint16_t i = 0; i < 256; i++) {
+    lut[i] = kern_rand();
+  }
+  for (uint8_t off = 0; off < 2; off++) {
+    for (uint32_t n = 0; n + off <= KERN_TEST_PX; n += (n < 9) ? 1 : 7) {
+      for (uint8_t k = 0; k < 5; k++) {
+        for (uint16_t i = 0; i < KERN_TEST_PX + 2; i++) {
+          src[i] = kern_rand();
+          a[i] = b[i] = kern_rand();
+        }
+        for (uint16_t i = 0; i < KERN_TEST_PX; i++) {
+          idx[i] = kern_rand();
+        }
+        uint8_t alpha = kern_rand() % 33;
+        uint8_t soff = (k == 4) ? !off : off; // 最后一轮测试两个缓冲对齐方式不同
+
+        switch (k) {
+        case 0:
+          ST7789_Memset16(a + off, src[0], n);
+          kern_memset16_c(b + off, src[0], n);
+          break;
+        case 1:
+          ST7789_Swap16(a + off, src + off, n);
+          kern_swap16_c(b + off, src + off, n);
+          break;
+        case 2:
+          ST7789_Expand8(a + off, idx, n, lut);
+          kern_expand8_c(b + off, idx, n, lut);
+          break;
+        case 3:
+          ST7789_Expand4(a + off, idx, n, lut);
+          kern_expand4_c(b + off, idx, n, lut);
+          break;
+        default:
+          ST7789_Blend565(a + off, src + soff, n, alpha);
+          kern_blend565_c(b + off, src + soff, n, alpha);
+          break;
+        }
+        if (memcmp(a, b, sizeof(a)) != 0) {
+          errors++;
+        }
+      }
+    }
+  }
+  kern_selftest_errors = errors;
+  return errors;
+}
+
+uint32_t ST7789_Kern_SelfTestErrors(void) {
+  return kern_selftest_errors;
+}
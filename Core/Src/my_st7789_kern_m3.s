@@ -0,0 +1,191 @@
+/**
+ * @name         : my_st7789_kern_m3.s
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-20 00:25:36
+ * @brief        : ST7789 像素内核的Cortex-M3汇编实现,由my_st7789_kern.c中的接口调用
+ * 这里只处理对齐好的整块数据,首尾零头和对齐检查在C接口中完成:
+ *   dst/src按字对齐;计数单位见各函数说明,不为0以外没有其他要求
+ * 成组的字用LDM/STM搬运,M3上n个寄存器的LDM/STM只需n+1个周期
+ * @version      : V1.2
+ * V1.1 2026-10-20 01:02:47 放入.ramfunc段,从SRAM运行
+ * V1.2 2026-10-20 08:20:44 改用CubeMX链接脚本已有的.RamFunc段,随.data一起复制到SRAM
+ */
+
+  .syntax unified
+  .cpu cortex-m3
+  .thumb
+
+/**
+ * void st7789_fill32_m3(uint32_t *dst, uint32_t v, uint32_t nwords)
+ * 每次循环用两条STM写8个字(16个像素)
+ */
+  .section .RamFunc.st7789_fill32_m3,"ax",%progbits
+  .p2align 2
+  .global st7789_fill32_m3
+  .type st7789_fill32_m3, %function
+st7789_fill32_m3:
+  push {r4, r5}
+  mov r3, r1
+  mov r4, r1
+  mov r5, r1
+  subs r2, r2, #8
+  blo 2f
+1:
+  stmia r0!, {r1, r3, r4, r5}
+  stmia r0!, {r1, r3, r4, r5}
+  subs r2, r2, #8
+  bhs 1b
+2:
+  adds r2, r2, #8
+  beq 4f
+3:
+  str r1, [r0], #4
+  subs r2, r2, #1
+  bne 3b
+4:
+  pop {r4, r5}
+  bx lr
+  .size st7789_fill32_m3, .-st7789_fill32_m3
+
+/**
+ * void st7789_rev16_m3(uint32_t *dst, const uint32_t *src, uint32_t nwords)
+ * 每个字中的两个像素各自交换高低字节;dst可以等于src
+ */
+  .section .RamFunc.st7789_rev16_m3,"ax",%progbits
+  .p2align 2
+  .global st7789_rev16_m3
+  .type st7789_rev16_m3, %function
+st7789_rev16_m3:
+  push {r4, r5, r6}
+  subs r2, r2, #4
+  blo 2f
+1:
+  ldmia r1!, {r3, r4, r5, r6}
+  rev16 r3, r3
+  rev16 r4, r4
+  rev16 r5, r5
+  rev16 r6, r6
+  stmia r0!, {r3, r4, r5, r6}
+  subs r2, r2, #4
+  bhs 1b
+2:
+  adds r2, r2, #4
+  beq 4f
+3:
+  ldr r3, [r1], #4
+  rev16 r3, r3
+  str r3, [r0], #4
+  subs r2, r2, #1
+  bne 3b
+4:
+  pop {r4, r5, r6}
+  bx lr
+  .size st7789_rev16_m3, .-st7789_rev16_m3
+
+/**
+ * void st7789_expand8_m3(uint32_t *dst, const uint8_t *src, uint32_t ngroups, const uint16_t *lut)
+ * 每组4个8bpp像素,查表后两两拼成字,一条STM写出;ngroups不为0
+ */
+  .section .RamFunc.st7789_expand8_m3,"ax",%progbits
+  .p2align 2
+  .global st7789_expand8_m3
+  .type st7789_expand8_m3, %function
+st7789_expand8_m3:
+  push {r4, r5, r6, r7}
+1:
+  ldrb r4, [r1], #1
+  ldrb r5, [r1], #1
+  ldrb r6, [r1], #1
+  ldrb r7, [r1], #1
+  ldrh r4, [r3, r4, lsl #1]
+  ldrh r5, [r3, r5, lsl #1]
+  ldrh r6, [r3, r6, lsl #1]
+  ldrh r7, [r3, r7, lsl #1]
+  orr r4, r4, r5, lsl #16
+  orr r5, r6, r7, lsl #16
+  stmia r0!, {r4, r5}
+  subs r2, r2, #1
+  bne 1b
+  pop {r4, r5, r6, r7}
+  bx lr
+  .size st7789_expand8_m3, .-st7789_expand8_m3
+
+/**
+ * void st7789_expand4_m3(uint32_t *dst, const uint8_t *src, uint32_t ngroups, const uint16_t *lut)
+ * 每组2个字节即4个4bpp像素,高半字节在前;ngroups不为0
+ */
+  .section .RamFunc.st7789_expand4_m3,"ax",%progbits
+  .p2align 2
+  .global st7789_expand4_m3
+  .type st7789_expand4_m3, %function
+st7789_expand4_m3:
+  push {r4, r5, r6, r7}
+1:
+  ldrb r4, [r1], #1
+  ldrb r6, [r1], #1
+  and r5, r4, #15
+  lsr r4, r4, #4
+  and r7, r6, #15
+  lsr r6, r6, #4
+  ldrh r4, [r3, r4, lsl #1]
+  ldrh r5, [r3, r5, lsl #1]
+  ldrh r6, [r3, r6, lsl #1]
+  ldrh r7, [r3, r7, lsl #1]
+  orr r4, r4, r5, lsl #16
+  orr r5, r6, r7, lsl #16
+  stmia r0!, {r4, r5}
+  subs r2, r2, #1
+  bne 1b
+  pop {r4, r5, r6, r7}
+  bx lr
+  .size st7789_expand4_m3, .-st7789_expand4_m3
+
+/**
+ * void st7789_blend565_m3(uint32_t *dst, const uint32_t *src, uint32_t npairs, uint32_t alpha)
+ * dst = src*alpha/32 + dst*(32-alpha)/32,alpha为0~32,像素为RGB565本机字节序;npairs不为0
+ * 像素展开成 00000gggggg00000rrrrr000000bbbbb 后,三个通道之间留有足够的空位,
+ * 一次乘法同时完成三个通道的插值,结果与逐通道计算完全相同
+ */
+  .section .RamFunc.st7789_blend565_m3,"ax",%progbits
+  .p2align 2
+  .global st7789_blend565_m3
+  .type st7789_blend565_m3, %function
+st7789_blend565_m3:
+  push {r4, r5, r6, r7, r8}
+  movw r12, #0xF81F
+  movt r12, #0x07E0
+1:
+  ldr r4, [r1], #4
+  ldr r5, [r0]
+  /* 低半字中的像素 */
+  uxth r6, r4
+  uxth r7, r5
+  orr r6, r6, r6, lsl #16
+  and r6, r6, r12
+  orr r7, r7, r7, lsl #16
+  and r7, r7, r12
+  sub r6, r6, r7
+  mul r6, r6, r3
+  add r7, r7, r6, lsr #5
+  and r7, r7, r12
+  orr r7, r7, r7, lsr #16
+  uxth r8, r7
+  /* 高半字中的像素 */
+  lsr r6, r4, #16
+  lsr r7, r5, #16
+  orr r6, r6, r6, lsl #16
+  and r6, r6, r12
+  orr r7, r7, r7, lsl #16
+  and r7, r7, r12
+  sub r6, r6, r7
+  mul r6, r6, r3
+  add r7, r7, r6, lsr #5
+  and r7, r7, r12
+  orr r7, r7, r7, lsr #16
+  orr r8, r8, r7, lsl #16
+  str r8, [r0], #4
+  subs r2, r2, #1
+  bne 1b
+  pop {r4, r5, r6, r7, r8}
+  bx lr
+  .size st7789_blend565_m3, .-st7789_blend565_m3
@@ -0,0 +1,123 @@
+/**
+ * @name         : my_st7789_m2m.c
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-20 02:21:40
+ * @brief        : ST7789 存储器到存储器DMA实现
+ * MEM2MEM模式下通道不等待外设请求,从CPAR读,写到CMAR(DIR=0),CNDTR减到0时置TCIF6
+ * 按字传输时首尾不满一个字的像素由CPU在启动DMA前写好,与DMA写入的地址不重叠
+ * 填充时CPAR指向m2m_pattern且不递增,传输期间m2m_pattern不能修改,所以新传输先等待旧传输
+ * @version      : V1.1
+ * V1.1 2026-10-20 09:41:36 传输错误保持到下一次ST7789_M2M_Wait报告,Fill16/Copy16内部的等待不再丢弃错误
+ */
+
+#include "my_st7789_m2m.h"
+#include "my_st7789_kern.h"
+#include <string.h>
+
+/* DMA1通道6的外设请求(USART2_RX,I2C1_TX,TIM3_CH1,TIM1_CH3)工程中都没有使用 */
+#define M2M_CH     DMA1_Channel6
+#define M2M_ISR_TC DMA_ISR_TCIF6
+#define M2M_ISR_TE DMA_ISR_TEIF6
+#define M2M_IFCR   DMA_IFCR_CGIF6
+
+#define M2M_CCR_WORD (DMA_CCR_MEM2MEM | DMA_CCR_MINC | DMA_CCR_PSIZE_1 | DMA_CCR_MSIZE_1)
+#define M2M_CCR_HALF (DMA_CCR_MEM2MEM | DMA_CCR_MINC | DMA_CCR_PSIZE_0 | DMA_CCR_MSIZE_0)
+
+static uint32_t m2m_pattern; // 填充源
+static uint8_t m2m_active;
+static uint8_t m2m_error; // 上一次ST7789_M2M_Wait之后有传输出错
+
+/**
+ * @brief 启动一次传输
+ * @param count 传输次数,单位由ccr中的PSIZE/MSIZE决定
+ */
+static void m2m_start(void *dst, const void *src, uint16_t count, uint32_t ccr) {
+  RCC->AHBENR |= RCC_AHBENR_DMA1EN;
+  M2M_CH->CCR = 0;
+  DMA1->IFCR = M2M_IFCR;
+  M2M_CH->CPAR = (uintptr_t)src;
+  M2M_CH->CMAR = (uintptr_t)dst;
+  M2M_CH->CNDTR = count;
+  M2M_CH->CCR = ccr | DMA_CCR_EN;
+  m2m_active = 1;
+}
+
+/**
+ * @brief 等待当前传输结束并关闭通道,出错时记下,由下一次ST7789_M2M_Wait报告
+ */
+static void m2m_finish(void) {
+  uint32_t isr;
+
+  if (!m2m_active) {
+    return;
+  }
+  do {
+    isr = DMA1->ISR;
+  } while (!(isr & (M2M_ISR_TC | M2M_ISR_TE)));
+  M2M_CH->CCR = 0;
+  DMA1->IFCR = M2M_IFCR;
+  m2m_active = 0;
+  if (isr & M2M_ISR_TE) {
+    m2m_error = 1;
+  }
+}
+
+/**
+ * @brief 后台填充
+ */
+void ST7789_M2M_Fill16(uint16_t *dst, uint16_t v, uint16_t n) {
+  m2m_finish();
+  if (n < ST7789_M2M_MIN_PX) {
+    ST7789_Memset16(dst, v, n);
+    return;
+  }
+  if ((uintptr_t)dst & 2) {
+    *dst++ = v;
+    n--;
+  }
+  if (n & 1) {
+    dst[n - 1] = v;
+  }
+  m2m_pattern = v | ((uint32_t)v << 16);
+  m2m_start(dst, &m2m_pattern, n / 2, M2M_CCR_WORD);
+}
+
+/**
+ * @brief 后台复制
+ */
+void ST7789_M2M_Copy16(uint16_t *dst, const uint16_t *src, uint16_t n) {
+  m2m_finish();
+  if (n < ST7789_M2M_MIN_PX) {
+    memcpy(dst, src, (uint32_t)n * 2);
+    return;
+  }
+  if (((uintptr_t)dst ^ (uintptr_t)src) & 2) {
+    m2m_start(dst, src, n, M2M_CCR_HALF | DMA_CCR_PINC);
+    return;
+  }
+  if ((uintptr_t)dst & 2) {
+    *dst++ = *src++;
+    n--;
+  }
+  if (n & 1) {
+    dst[n - 1] = src[n - 1];
+  }
+  m2m_start(dst, src, n / 2, M2M_CCR_WORD | DMA_CCR_PINC);
+}
+
+/**
+ * @brief 等待当前传输结束并关闭通道
+ * @retval HAL_ERROR 上一次调用之后有传输出错,包括被下一次Fill16/Copy16等待结束的传输;报告后清除
+ */
+HAL_StatusTypeDef ST7789_M2M_Wait(void) {
+  m2m_finish();
+  if (m2m_error) {
+    m2m_error = 0;
+    return HAL_ERROR;
+  }
+  return HAL_OK;
+}
+
+uint8_t ST7789_M2M_Busy(void) {
+  return m2m_active && !(DMA1->ISR & (M2M_ISR_TC | M2M_ISR_TE));
+}
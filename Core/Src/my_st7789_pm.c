@@ -0,0 +1,126 @@
+/**
+ * @name         : my_st7789_pm.c
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-19 18:10:42
+ * @brief        : ST7789 面板睡眠管理实现
+ * 面板只在总线空闲时进入睡眠,而完成回调只会在传输进行中被调用,所以唤醒总是发生在主循环中,
+ * 可以阻塞等待120ms间隔和SLPOUT后的5ms
+ * @version      : V1.1
+ * V1.1 2026-10-19 19:02:17 PWM背光时睡眠前记下亮度,唤醒后恢复
+ */
+
+#include "my_st7789_pm.h"
+#include "my_st7789_ll.h"
+#include "my_st7789_backlight.h"
+
+static uint32_t pm_timeout;               // 无绘制多久后睡眠,0表示不自动睡眠
+static volatile uint32_t pm_last_activity; // 最近一次绘制的时刻
+static uint32_t pm_last_change;           // 最近一次SLPIN/SLPOUT的时刻
+static volatile uint8_t pm_sleeping;
+#if ST7789_BACKLIGHT_PWM
+static uint8_t pm_bl_level; // 睡眠前的背光亮度
+#endif
+
+static void pm_backlight_off(void) {
+#if ST7789_BACKLIGHT_PWM
+  pm_bl_level = ST7789_Backlight_Get();
+  ST7789_Backlight_Set(0);
+#else
+  ST7789_BLK_Clr();
+#endif
+}
+
+static void pm_backlight_on(void) {
+#if ST7789_BACKLIGHT_PWM
+  ST7789_Backlight_Set(pm_bl_level);
+#else
+  ST7789_BLK_Set();
+#endif
+}
+
+/**
+ * @brief 保证距上一次SLPIN/SLPOUT至少ST7789_PM_SLEEP_SPACING_MS
+ */
+static void pm_wait_spacing(void) {
+  uint32_t elapsed = HAL_GetTick() - pm_last_change;
+
+  if (elapsed < ST7789_PM_SLEEP_SPACING_MS) {
+    HAL_Delay(ST7789_PM_SLEEP_SPACING_MS - elapsed);
+  }
+}
+
+/**
+ * @brief 记录一次SLPOUT,由ST7789_Init调用
+ */
+void st7789_pm_reset(void) {
+  pm_last_change = HAL_GetTick();
+  pm_last_activity = pm_last_change;
+  pm_sleeping = 0;
+}
+
+/**
+ * @brief 记录一次绘制,面板睡眠时先唤醒
+ * @note 由绘制入口在启动传输前调用;面板睡眠时只会从主循环进入,不能在关中断时调用
+ */
+void st7789_pm_activity(void) {
+  pm_last_activity = HAL_GetTick();
+  if (pm_sleeping) {
+    ST7789_PM_Wake();
+  }
+}
+
+/**
+ * @brief 设置自动睡眠的空闲时间
+ * @param ms 毫秒,0表示关闭自动睡眠;小于120ms时实际睡眠仍受间隔限制
+ */
+void ST7789_PM_SetTimeout(uint32_t ms) {
+  pm_timeout = ms;
+}
+
+/**
+ * @brief 空闲超时后让面板睡眠,在主循环中周期调用
+ */
+void ST7789_PM_Poll(void) {
+  if (pm_timeout == 0 || pm_sleeping || ST7789_IsBusy()) {
+    return;
+  }
+  if (HAL_GetTick() - pm_last_activity >= pm_timeout) {
+    ST7789_PM_Sleep();
+  }
+}
+
+/**
+ * @brief 立即让面板睡眠
+ * @note 等待已提交的绘制完成,GRAM内容在睡眠期间保持
+ */
+void ST7789_PM_Sleep(void) {
+  if (pm_sleeping) {
+    return;
+  }
+  ST7789_WaitIdle();
+  pm_wait_spacing();
+  pm_backlight_off();
+  ST7789_WriteCmd(ST7789_SLPIN);
+  pm_last_change = HAL_GetTick();
+  pm_sleeping = 1;
+}
+
+/**
+ * @brief 唤醒面板
+ */
+void ST7789_PM_Wake(void) {
+  if (!pm_sleeping) {
+    return;
+  }
+  pm_wait_spacing();
+  ST7789_WriteCmd(ST7789_SLPOUT);
+  HAL_Delay(ST7789_PM_SLPOUT_DELAY_MS);
+  pm_backlight_on();
+  pm_last_change = HAL_GetTick();
+  pm_last_activity = pm_last_change;
+  pm_sleeping = 0;
+}
+
+uint8_t ST7789_PM_IsSleeping(void) {
+  return pm_sleeping;
+}
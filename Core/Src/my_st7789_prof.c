@@ -0,0 +1,128 @@
+/**
+ * @name         : my_st7789_prof.c
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-19 14:12:48
+ * @brief        : ST7789 驱动性能统计实现
+ * CYCCNT为32位,72MHz下约59秒回绕一次,单次调用的差值计算不受回绕影响
+ * @version      : V1.1
+ * V1.1 2026-10-20 08:41:09 增加各绘制入口的名称
+ */
+
+#include "my_st7789_prof.h"
+#include "my_st7789_ll.h"
+
+#if ST7789_PROFILE
+
+#include <stdio.h>
+
+static const char *const prof_names[ST7789_PROF_COUNT] = {
+    [ST7789_PROF_INIT] = "ST7789_Init",
+    [ST7789_PROF_FILL_COLOR] = "ST7789_Fill_Color",
+    [ST7789_PROF_SPRITE_COMPOSE] = "sprite_compose",
+    [ST7789_PROF_DLIST_SUBMIT] = "ST7789_DList_Submit",
+    [ST7789_PROF_FILL] = "ST7789_Fill",
+    [ST7789_PROF_DRAW_IMAGE] = "ST7789_DrawImage",
+    [ST7789_PROF_BLIT] = "ST7789_Blit",
+    [ST7789_PROF_AFFINE_DRAW] = "ST7789_Affine_Draw",
+    [ST7789_PROF_SHADE] = "ST7789_Shade",
+    [ST7789_PROF_COMP_RENDER] = "ST7789_Comp_Render",
+    [ST7789_PROF_TILE_RENDER] = "ST7789_Tile_Render",
+    [ST7789_PROF_FB_FLUSH] = "ST7789_FB_Flush",
+    [ST7789_PROF_WRITE_CMD] = "ST7789_WriteCmd",
+    [ST7789_PROF_WRITE_DATA] = "ST7789_WriteData",
+    [ST7789_PROF_WRITE_BUF] = "st7789_write_data_buf",
+    [ST7789_PROF_SET_WINDOW] = "ST7789_SetAddressWindow",
+    [ST7789_PROF_XFER_SUBMIT] = "ST7789_Xfer_Submit",
+    [ST7789_PROF_XFER_DMA] = "xfer_dma_chunk",
+};
+
+static ST7789_ProfEntry prof_table[ST7789_PROF_COUNT];
+static volatile uint32_t prof_bytes; // 累计发送字节数,用于计算每次调用期间的增量
+
+/**
+ * @brief 打开DWT周期计数器并清空统计
+ */
+void ST7789_Prof_Init(void) {
+  st7789_dwt_enable();
+  ST7789_Prof_Reset();
+}
+
+/**
+ * @brief 清空所有统计项
+ */
+void ST7789_Prof_Reset(void) {
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  for (uint8_t i = 0; i < ST7789_PROF_COUNT; i++) {
+    prof_table[i].calls = 0;
+    prof_table[i].total_cycles = 0;
+    prof_table[i].max_cycles = 0;
+    prof_table[i].bytes = 0;
+  }
+  __set_PRIMASK(primask);
+}
+
+/**
+ * @brief 查询单个统计项
+ */
+const ST7789_ProfEntry *ST7789_Prof_Get(ST7789_ProfId id) {
+  return id < ST7789_PROF_COUNT ? &prof_table[id] : NULL;
+}
+
+void ST7789_Prof_Begin(ST7789_ProfMark *mark) {
+  mark->bytes = prof_bytes;
+  mark->cycles = DWT->CYCCNT;
+}
+
+void ST7789_Prof_End(ST7789_ProfId id, const ST7789_ProfMark *mark) {
+  uint32_t cycles = DWT->CYCCNT - mark->cycles;
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  ST7789_ProfEntry *e = &prof_table[id];
+  e->calls++;
+  e->total_cycles += cycles;
+  if (cycles > e->max_cycles) {
+    e->max_cycles = cycles;
+  }
+  e->bytes += prof_bytes - mark->bytes;
+  __set_PRIMASK(primask);
+}
+
+/**
+ * @brief 记录经SPI发出的字节数,由底层传输函数调用
+ * @note 主循环和DMA中断都会调用,需要关中断保证累加的原子性
+ */
+void ST7789_Prof_AddBytes(uint32_t n) {
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  prof_bytes += n;
+  __set_PRIMASK(primask);
+}
+
+/**
+ * @brief 按表格格式输出所有调用过的统计项
+ * @param sink 行输出回调
+ * @note 周期按SystemCoreClock换算成微秒
+ */
+void ST7789_Prof_Dump(ST7789_ProfSink sink) {
+  char line[96];
+  uint32_t mhz = SystemCoreClock / 1000000;
+
+  if (mhz == 0) {
+    mhz = 1;
+  }
+  snprintf(line, sizeof(line), "%-24s %8s %12s %10s %10s\r\n", "name", "calls", "total_us", "max_us", "bytes");
+  sink(line);
+  for (uint8_t i = 0; i < ST7789_PROF_COUNT; i++) {
+    const ST7789_ProfEntry *e = &prof_table[i];
+    if (e->calls == 0) {
+      continue;
+    }
+    snprintf(line, sizeof(line), "%-24s %8lu %12lu %10lu %10lu\r\n", prof_names[i],
+             (unsigned long)e->calls, (unsigned long)(e->total_cycles / mhz),
+             (unsigned long)(e->max_cycles / mhz), (unsigned long)e->bytes);
+    sink(line);
+  }
+}
+
+#endif
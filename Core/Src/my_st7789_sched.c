@@ -0,0 +1,217 @@
+/**
+ * @name         : my_st7789_sched.c
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-19 19:48:30
+ * @brief        : ST7789 绘制任务调度实现
+ * 任何时刻最多只有一个块在传输引擎中,块的完成回调负责选择并提交下一块,
+ * 所以抢占不需要主循环参与,主循环被阻塞时调度也照常进行
+ * @version      : V1.1
+ * V1.1 2026-10-20 09:20:53 块完成时先提交下一块再调用任务完成回调;提交失败的任务在等待和查询时重试
+ */
+
+#include "my_st7789_sched.h"
+#include "my_st7789_ll.h"
+#include "my_st7789_xfer.h"
+
+typedef struct {
+  ST7789_Job job;
+  uint16_t row;  // 下一块的起始行(相对任务窗口)
+  uint32_t seq;  // 提交序号
+  uint8_t used;
+} sched_entry_t;
+
+static sched_entry_t sched_jobs[ST7789_SCHED_MAX_JOBS];
+static volatile uint8_t sched_count;
+static volatile uint8_t sched_inflight; // 有一个块在传输引擎中
+static uint32_t sched_seq;
+static uint32_t sched_missed;
+
+static void sched_chunk_done(void *ctx);
+
+/**
+ * @brief a是否应该排在b前面
+ */
+static uint8_t sched_before(const sched_entry_t *a, const sched_entry_t *b) {
+  if (a->job.priority != b->job.priority) {
+    return a->job.priority > b->job.priority;
+  }
+  if (a->job.deadline != b->job.deadline) {
+    if (a->job.deadline == 0 || b->job.deadline == 0) {
+      return b->job.deadline == 0;
+    }
+    return (int32_t)(a->job.deadline - b->job.deadline) < 0;
+  }
+  return (int32_t)(a->seq - b->seq) < 0;
+}
+
+static sched_entry_t *sched_pick(void) {
+  sched_entry_t *best = NULL;
+
+  for (uint8_t i = 0; i < ST7789_SCHED_MAX_JOBS; i++) {
+    sched_entry_t *e = &sched_jobs[i];
+    if (e->used && (best == NULL || sched_before(e, best))) {
+      best = e;
+    }
+  }
+  return best;
+}
+
+/**
+ * @brief 选择任务并提交它的下一块
+ * @retval 0 传输引擎队列已满,未能提交
+ * @note 在中断中或关中断时调用
+ */
+static uint8_t sched_dispatch(void) {
+  if (sched_inflight) {
+    return 1;
+  }
+  sched_entry_t *e = sched_pick();
+  if (e == NULL) {
+    return 1;
+  }
+
+  const ST7789_Job *j = &e->job;
+  uint16_t rows = ST7789_SCHED_CHUNK_BYTES / (2u * j->w);
+  if (rows == 0) {
+    rows = 1;
+  }
+  if (rows > j->h - e->row) {
+    rows = j->h - e->row;
+  }
+
+  ST7789_Xfer x = {
+      .x0 = j->x, .y0 = j->y + e->row, .x1 = j->x + j->w - 1, .y1 = j->y + e->row + rows - 1,
+      .count = (uint32_t)j->w * rows,
+      .done = sched_chunk_done,
+      .ctx = e,
+  };
+  if (j->image) {
+    x.mode = ST7789_XFER_COPY;
+    x.src = j->image + (uint32_t)j->w * e->row;
+  } else {
+    x.mode = ST7789_XFER_REPEAT;
+    x.color = j->color;
+  }
+  if (ST7789_Xfer_Submit(&x) != HAL_OK) {
+    return 0;
+  }
+  e->row += rows;
+  sched_inflight = 1;
+  return 1;
+}
+
+/**
+ * @brief 块发送完成,在DMA中断中调用
+ * @note 刚完成的块已从传输队列出队,队列至少有一个空位,所以先提交下一块再调用任务的完成回调;
+ *       回调中提交的异步绘制即使占满队列,也不会挤掉调度器的下一块
+ */
+static void sched_chunk_done(void *ctx) {
+  sched_entry_t *e = ctx;
+  ST7789_JobCallback done = NULL;
+  void *done_ctx = NULL;
+  uint8_t late = 0;
+
+  sched_inflight = 0;
+  if (e->row >= e->job.h) {
+    done = e->job.done;
+    done_ctx = e->job.ctx;
+    late = e->job.deadline != 0 && (int32_t)(HAL_GetTick() - e->job.deadline) > 0;
+
+    e->used = 0;
+    sched_count--;
+    if (late) {
+      sched_missed++;
+    }
+  }
+  sched_dispatch();
+  if (done) {
+    done(done_ctx, late);
+  }
+}
+
+/**
+ * @brief 没有块在传输引擎中但还有任务时重新提交
+ * @note 任务在中断中提交而传输队列已满时会停在这个状态,直到这里或下一次ST7789_Sched_Submit重试
+ */
+static void sched_retry(void) {
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  if (!sched_inflight && sched_count > 0) {
+    sched_dispatch();
+  }
+  __set_PRIMASK(primask);
+}
+
+/**
+ * @brief 提交一个绘制任务,立即返回
+ * @retval HAL_BUSY 任务表已满
+ * @retval HAL_ERROR 窗口超出屏幕
+ * @note 可以在主循环或完成回调中调用;在完成回调中提交且传输队列已满时不等待,
+ *       任务在队列有空位后由ST7789_Sched_Wait/ST7789_Sched_IsBusy启动
+ */
+HAL_StatusTypeDef ST7789_Sched_Submit(const ST7789_Job *job) {
+  if (job->w == 0 || job->h == 0 || job->x + job->w > ST7789_WIDTH || job->y + job->h > ST7789_HEIGHT) {
+    return HAL_ERROR;
+  }
+  st7789_pixel_flush();
+  st7789_pm_activity(); // 面板睡眠时先在关中断之前唤醒
+
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  sched_entry_t *slot = NULL;
+  for (uint8_t i = 0; i < ST7789_SCHED_MAX_JOBS; i++) {
+    if (!sched_jobs[i].used) {
+      slot = &sched_jobs[i];
+      break;
+    }
+  }
+  if (slot == NULL) {
+    __set_PRIMASK(primask);
+    return HAL_BUSY;
+  }
+  slot->job = *job;
+  slot->row = 0;
+  slot->seq = sched_seq++;
+  slot->used = 1;
+  sched_count++;
+  uint8_t ok = sched_dispatch();
+  __set_PRIMASK(primask);
+
+  /* 传输引擎被其他模块占满时,等队列排空后再启动;中断(完成回调)中不能等待,
+     任务留在表中,由ST7789_Sched_Wait/ST7789_Sched_IsBusy在队列有空位后重试 */
+  while (!ok && __get_IPSR() == 0) {
+    while (ST7789_Xfer_IsBusy()) {
+      ST7789_SLEEP_WHILE(ST7789_Xfer_IsBusy());
+    }
+    primask = __get_PRIMASK();
+    __disable_irq();
+    ok = sched_dispatch();
+    __set_PRIMASK(primask);
+  }
+  return HAL_OK;
+}
+
+/**
+ * @brief 是否还有未完成的任务
+ */
+uint8_t ST7789_Sched_IsBusy(void) {
+  sched_retry();
+  return sched_count > 0;
+}
+
+/**
+ * @brief 等待所有任务完成
+ */
+void ST7789_Sched_Wait(void) {
+  while (sched_count > 0) {
+    sched_retry(); // 队列被异步绘制占满时,每完成一个事务重试一次
+    ST7789_SLEEP_WHILE(sched_count > 0);
+  }
+}
+
+/**
+ * @brief 超过截止时间才完成的任务数
+ */
+uint32_t ST7789_Sched_MissedDeadlines(void) {
+  return sched_missed;
+}
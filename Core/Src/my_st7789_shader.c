@@ -0,0 +1,214 @@
+/**
+ * @name         : my_st7789_shader.c
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-20 02:58:03
+ * @brief        : ST7789 逐行着色器实现
+ * 渐变的插值参数t为0~256,每个通道按 c0*256+(c1-c0)*t 计算出带8位小数的值,
+ * 抖动时加上4x4 Bayer阈值再取整,否则加128四舍五入
+ * 径向渐变不逐点开方:同一行中相邻像素到圆心的距离最多相差1,上一点的平方根只需要上下调整几步
+ * @version      : V1.3
+ * V1.1 2026-10-20 07:05:18 径向渐变半径以外t取256,抖动时不再出现c1以外的颜色
+ * V1.2 2026-10-20 07:40:12 逐行发送改用st7789_stream_rows
+ * V1.3 2026-10-20 08:41:09 加入性能统计
+ */
+
+#include "my_st7789_shader.h"
+#include "my_st7789_kern.h"
+#include "my_st7789_ll.h"
+#include "my_st7789_prof.h"
+
+static const uint8_t shader_bayer[4][4] = {
+    {0, 8, 2, 10},
+    {12, 4, 14, 6},
+    {3, 11, 1, 9},
+    {15, 7, 13, 5},
+};
+
+typedef struct {
+  ST7789_ShaderFunc shader;
+  void *ctx;
+  uint16_t x0, x1, y0;
+} shader_job_t;
+
+static const uint16_t *shader_row(uint16_t row, uint16_t *line, void *ctx) {
+  const shader_job_t *j = ctx;
+
+  j->shader(j->y0 + row, j->x0, j->x1, line, j->ctx);
+  return line;
+}
+
+/**
+ * @brief 用着色器填充窗口
+ * @note 由st7789_stream_rows逐行发送,生成第k行时第k-1行仍在DMA发送
+ */
+void ST7789_Shade(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, ST7789_ShaderFunc shader, void *ctx) {
+  if (x1 >= ST7789_WIDTH) {
+    x1 = ST7789_WIDTH - 1;
+  }
+  if (y1 >= ST7789_HEIGHT) {
+    y1 = ST7789_HEIGHT - 1;
+  }
+  if (x0 > x1 || y0 > y1) {
+    return;
+  }
+
+  ST7789_PROF_BEGIN();
+  shader_job_t j = {shader, ctx, x0, x1, y0};
+  st7789_stream_rows(x0, y0, x1, y1, shader_row, &j);
+  ST7789_PROF_END(ST7789_PROF_SHADE);
+}
+
+/**
+ * @brief c0到c1的插值,返回面板字节序
+ * @param t 0~256
+ * @param d 抖动阈值0~255
+ */
+static inline uint16_t shader_lerp(uint16_t c0, uint16_t c1, int32_t t, uint8_t d) {
+  int32_t r0 = c0 >> 11, g0 = (c0 >> 5) & 0x3F, b0 = c0 & 0x1F;
+  int32_t r = ((r0 << 8) + ((c1 >> 11) - r0) * t + d) >> 8;
+  int32_t g = ((g0 << 8) + (((c1 >> 5) & 0x3F) - g0) * t + d) >> 8;
+  int32_t b = ((b0 << 8) + ((c1 & 0x1F) - b0) * t + d) >> 8;
+  return ST7789_SWAP16((uint16_t)((r << 11) | (g << 5) | b));
+}
+
+static inline const uint8_t *shader_dither_row(uint8_t dither, uint16_t y) {
+  return dither ? shader_bayer[y & 3] : NULL;
+}
+
+static inline uint8_t shader_threshold(const uint8_t *row, uint16_t x) {
+  return row ? row[x & 3] * 16 + 8 : 128;
+}
+
+/**
+ * @brief 线性渐变
+ * @note t按16.16定点沿行累加,每行只做一次64位除法
+ */
+void ST7789_Shader_Linear(uint16_t y, uint16_t x0, uint16_t x1, uint16_t *out, void *ctx) {
+  const ST7789_LinearGradient *g = ctx;
+  int32_t dx = g->x1 - g->x0, dy = g->y1 - g->y0;
+  int64_t len2 = (int64_t)dx * dx + (int64_t)dy * dy;
+  const uint8_t *bayer = shader_dither_row(g->dither, y);
+
+  if (len2 == 0) {
+    ST7789_Memset16(out, ST7789_SWAP16(g->c0), x1 - x0 + 1);
+    return;
+  }
+  int64_t num = (int64_t)(x0 - g->x0) * dx + (int64_t)(y - g->y0) * dy;
+  int64_t acc = num * 65536 / len2; // 0~65536对应两个端点
+  int32_t step = (int32_t)((int64_t)dx * 65536 / len2);
+  for (uint16_t x = x0; x <= x1; x++) {
+    int32_t t = acc < 0 ? 0 : acc > 65536 ? 256 : (int32_t)(acc >> 8);
+    *out++ = shader_lerp(g->c0, g->c1, t, shader_threshold(bayer, x));
+    acc += step;
+  }
+}
+
+/**
+ * @brief 整数平方根,向下取整
+ */
+static uint32_t shader_isqrt(uint32_t v) {
+  uint32_t r = 0, bit = 1u << 30;
+
+  while (bit > v) {
+    bit >>= 2;
+  }
+  while (bit) {
+    if (v >= r + bit) {
+      v -= r + bit;
+      r = (r >> 1) + bit;
+    } else {
+      r >>= 1;
+    }
+    bit >>= 2;
+  }
+  return r;
+}
+
+/**
+ * @brief 径向渐变
+ * @note q为距离的16倍取整,即 floor(sqrt(d2*256));d2超过r^2时截断,q不超过16r
+ *       t = q*256/(16r) = q*(2^20/r) >> 16,截断处t取256
+ */
+void ST7789_Shader_Radial(uint16_t y, uint16_t x0, uint16_t x1, uint16_t *out, void *ctx) {
+  const ST7789_RadialGradient *g = ctx;
+  uint32_t r = g->r ? g->r : 1;
+  if (r > 4095) {
+    r = 4095; // 保证d2*256不溢出
+  }
+  uint32_t cap = r * r;
+  uint32_t inv = (1u << 20) / r;
+  int32_t dy = (int32_t)y - g->cy;
+  uint32_t dy2 = (uint32_t)(dy * dy);
+  const uint8_t *bayer = shader_dither_row(g->dither, y);
+  uint32_t q = 0xFFFFFFFFu; // 行首重新开方
+
+  for (uint16_t x = x0; x <= x1; x++) {
+    int32_t dx = (int32_t)x - g->cx;
+    uint32_t d2 = dy2 >= cap ? cap : dy2 + (uint32_t)(dx * dx);
+    if (d2 > cap) {
+      d2 = cap;
+    }
+    uint32_t v = d2 << 8;
+    if (q == 0xFFFFFFFFu) {
+      q = shader_isqrt(v);
+    } else {
+      while ((q + 1) * (q + 1) <= v) {
+        q++;
+      }
+      while (q * q > v) {
+        q--;
+      }
+    }
+    // inv向下取整,q*inv在半径处只能到255,截断后直接取端点,保证半径以外是纯c1
+    int32_t t = d2 == cap ? 256 : (int32_t)((q * inv) >> 16);
+    *out++ = shader_lerp(g->c0, g->c1, t, shader_threshold(bayer, x));
+  }
+}
+
+/**
+ * @brief 按坐标pos每size个像素交替c0/c1输出n个像素,flip为1时从c1开始
+ */
+static void shader_runs(uint16_t *out, uint16_t n, uint32_t pos, uint16_t size, uint8_t flip, uint16_t c0,
+                        uint16_t c1) {
+  uint16_t p0 = ST7789_SWAP16(c0), p1 = ST7789_SWAP16(c1);
+
+  if (size == 0) {
+    size = 1;
+  }
+  uint8_t odd = ((pos / size) & 1) ^ flip;
+  uint16_t run = size - pos % size;
+  while (n > 0) {
+    if (run > n) {
+      run = n;
+    }
+    ST7789_Memset16(out, odd ? p1 : p0, run);
+    out += run;
+    n -= run;
+    odd ^= 1;
+    run = size;
+  }
+}
+
+void ST7789_Shader_Checker(uint16_t y, uint16_t x0, uint16_t x1, uint16_t *out, void *ctx) {
+  const ST7789_Checker *c = ctx;
+  uint16_t size = c->size ? c->size : 1;
+
+  shader_runs(out, x1 - x0 + 1, x0, size, (y / size) & 1, c->c0, c->c1);
+}
+
+void ST7789_Shader_Stripes(uint16_t y, uint16_t x0, uint16_t x1, uint16_t *out, void *ctx) {
+  const ST7789_Stripes *s = ctx;
+  uint16_t w = s->width ? s->width : 1;
+
+  switch (s->dir) {
+  case ST7789_STRIPE_V:
+    shader_runs(out, x1 - x0 + 1, x0, w, 0, s->c0, s->c1);
+    break;
+  case ST7789_STRIPE_D:
+    shader_runs(out, x1 - x0 + 1, (uint32_t)x0 + y, w, 0, s->c0, s->c1);
+    break;
+  default:
+    ST7789_Memset16(out, ST7789_SWAP16(((y / w) & 1) ? s->c1 : s->c0), x1 - x0 + 1);
+    break;
+  }
+}
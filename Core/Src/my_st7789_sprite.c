@@ -0,0 +1,321 @@
+/**
+ * @name         : my_st7789_sprite.c
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-19 10:02:41
+ * @brief        : ST7789 精灵层实现
+ * 精灵移动时只重绘新旧包围盒,在一行缓冲中由背景和所有精灵按z序合成,再作为一个窗口连续发送,
+ * 避免逐像素设置窗口
+ * @version      : V1.3
+ * V1.1 2026-10-20 01:02:47 行合成放入SRAM运行
+ * V1.2 2026-10-20 08:02:36 行缓冲改为st7789_stream_rows从内存池分配的两个行缓冲
+ * V1.3 2026-10-20 11:21:06 拒绝重复加入同一精灵;移除时保留原来的可见标志
+ */
+
+#include "my_st7789_sprite.h"
+#include "my_st7789_ll.h"
+#include "my_st7789_prof.h"
+
+typedef struct {
+  int16_t x0, y0, x1, y1; // 闭区间
+} sprite_rect_t;
+
+static ST7789_Sprite *sprite_list[ST7789_SPRITE_MAX]; // 按z序从小到大排列
+static uint8_t sprite_count;
+
+static ST7789_BgFunc bg_func;
+static void *bg_ctx;
+static uint16_t bg_color; // 面板字节序
+
+/**
+ * @brief 默认背景:纯色
+ */
+static void sprite_bg_solid(uint16_t y, uint16_t x0, uint16_t x1, uint16_t *out, void *ctx) {
+  (void)y;
+  (void)ctx;
+  for (uint16_t x = x0; x <= x1; x++) {
+    *out++ = bg_color;
+  }
+}
+
+/**
+ * @brief 计算精灵在(x,y)处的包围盒并裁剪到屏幕
+ * @return 1: 包围盒在屏幕内, 0: 完全在屏幕外
+ */
+static uint8_t sprite_get_rect(const ST7789_Sprite *s, int16_t x, int16_t y, sprite_rect_t *r) {
+  int32_t x0 = x, y0 = y;
+  int32_t x1 = x0 + s->w - 1, y1 = y0 + s->h - 1;
+
+  if (x0 < 0) x0 = 0;
+  if (y0 < 0) y0 = 0;
+  if (x1 > ST7789_WIDTH - 1) x1 = ST7789_WIDTH - 1;
+  if (y1 > ST7789_HEIGHT - 1) y1 = ST7789_HEIGHT - 1;
+  if (x0 > x1 || y0 > y1) {
+    return 0;
+  }
+
+  r->x0 = x0;
+  r->y0 = y0;
+  r->x1 = x1;
+  r->y1 = y1;
+  return 1;
+}
+
+static uint32_t sprite_rect_area(const sprite_rect_t *r) {
+  return (uint32_t)(r->x1 - r->x0 + 1) * (uint32_t)(r->y1 - r->y0 + 1);
+}
+
+/**
+ * @brief 把一个精灵在第y行x0~x1范围内的不透明像素叠加到行缓冲
+ */
+static ST7789_RAMFUNC void sprite_blend_row(const ST7789_Sprite *s, int16_t y, int16_t x0, int16_t x1, uint16_t *out) {
+  if (y < s->y || y >= s->y + (int16_t)s->h) {
+    return;
+  }
+
+  int16_t sx0 = s->x > x0 ? s->x : x0;
+  int16_t sx1 = s->x + (int16_t)s->w - 1 < x1 ? s->x + (int16_t)s->w - 1 : x1;
+  if (sx0 > sx1) {
+    return;
+  }
+
+  uint16_t row = y - s->y;
+  const uint16_t *src = s->image + (uint32_t)row * s->w;
+  const uint8_t *mask = s->mask ? s->mask + (uint32_t)row * ((s->w + 7) / 8) : NULL;
+  uint8_t use_key = s->flags & ST7789_SPRITE_COLORKEY;
+
+  for (int16_t x = sx0; x <= sx1; x++) {
+    uint16_t u = x - s->x;
+    if (mask && !(mask[u >> 3] & (0x80 >> (u & 7)))) {
+      continue;
+    }
+    if (use_key && src[u] == s->key) {
+      continue;
+    }
+    out[x - x0] = src[u];
+  }
+}
+
+static const uint16_t *sprite_row(uint16_t row, uint16_t *line, void *ctx) {
+  const sprite_rect_t *r = ctx;
+  int16_t y = r->y0 + row;
+
+  bg_func(y, r->x0, r->x1, line, bg_ctx);
+  for (uint8_t i = 0; i < sprite_count; i++) {
+    if (sprite_list[i]->flags & ST7789_SPRITE_VISIBLE) {
+      sprite_blend_row(sprite_list[i], y, r->x0, r->x1, line);
+    }
+  }
+  return line;
+}
+
+/**
+ * @brief 重新合成并发送一个屏幕矩形
+ * @note 整个矩形只设置一次地址窗口,由st7789_stream_rows逐行合成,合成下一行时上一行仍在发送
+ */
+static void sprite_compose(const sprite_rect_t *r) {
+  ST7789_PROF_BEGIN();
+  st7789_stream_rows(r->x0, r->y0, r->x1, r->y1, sprite_row, (void *)r);
+  ST7789_PROF_END(ST7789_PROF_SPRITE_COMPOSE);
+}
+
+static uint8_t sprite_attached(const ST7789_Sprite *s) {
+  for (uint8_t i = 0; i < sprite_count; i++) {
+    if (sprite_list[i] == s) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief 重绘精灵旧位置和新位置
+ * @note 两个包围盒的并集面积不超过二者面积之和时合并为一个窗口,
+ *       否则(相距较远)分成两个窗口,避免重绘中间无关的大片区域
+ */
+static void sprite_refresh(ST7789_Sprite *s) {
+  sprite_rect_t old_r, new_r;
+
+  if (!s->drawn && !sprite_attached(s)) {
+    return; // 未挂到精灵层,只记录状态
+  }
+
+  uint8_t has_old = s->drawn && sprite_get_rect(s, s->drawn_x, s->drawn_y, &old_r);
+  uint8_t has_new = (s->flags & ST7789_SPRITE_VISIBLE) && sprite_get_rect(s, s->x, s->y, &new_r);
+
+  if (has_old && has_new) {
+    sprite_rect_t u;
+    u.x0 = old_r.x0 < new_r.x0 ? old_r.x0 : new_r.x0;
+    u.y0 = old_r.y0 < new_r.y0 ? old_r.y0 : new_r.y0;
+    u.x1 = old_r.x1 > new_r.x1 ? old_r.x1 : new_r.x1;
+    u.y1 = old_r.y1 > new_r.y1 ? old_r.y1 : new_r.y1;
+    if (sprite_rect_area(&u) <= sprite_rect_area(&old_r) + sprite_rect_area(&new_r)) {
+      sprite_compose(&u);
+    } else {
+      sprite_compose(&old_r);
+      sprite_compose(&new_r);
+    }
+  } else if (has_old) {
+    sprite_compose(&old_r);
+  } else if (has_new) {
+    sprite_compose(&new_r);
+  }
+
+  s->drawn = (s->flags & ST7789_SPRITE_VISIBLE) ? 1 : 0;
+  s->drawn_x = s->x;
+  s->drawn_y = s->y;
+}
+
+/**
+ * @brief 初始化精灵,默认可见,不透明
+ * @param s 精灵
+ * @param w 宽度
+ * @param h 高度
+ * @param image 像素数据,面板字节序
+ */
+void ST7789_Sprite_Init(ST7789_Sprite *s, uint16_t w, uint16_t h, const uint16_t *image) {
+  s->x = 0;
+  s->y = 0;
+  s->w = w;
+  s->h = h;
+  s->image = image;
+  s->mask = NULL;
+  s->key = 0;
+  s->z = 0;
+  s->flags = ST7789_SPRITE_VISIBLE;
+  s->drawn_x = 0;
+  s->drawn_y = 0;
+  s->drawn = 0;
+}
+
+/**
+ * @brief 设置色键,与色键相同的像素视为透明
+ * @param key RGB565颜色
+ */
+void ST7789_Sprite_SetColorKey(ST7789_Sprite *s, uint16_t key) {
+  s->key = ST7789_SWAP16(key);
+  s->flags |= ST7789_SPRITE_COLORKEY;
+}
+
+/**
+ * @brief 设置1bpp遮罩,为NULL时取消遮罩
+ */
+void ST7789_Sprite_SetMask(ST7789_Sprite *s, const uint8_t *mask) {
+  s->mask = mask;
+}
+
+/**
+ * @brief 设置背景行回调
+ * @note 不会立即重绘,需要时调用ST7789_Sprite_Redraw
+ */
+void ST7789_Sprite_SetBackground(ST7789_BgFunc fn, void *ctx) {
+  bg_func = fn;
+  bg_ctx = ctx;
+}
+
+/**
+ * @brief 使用纯色背景
+ * @param color RGB565颜色
+ */
+void ST7789_Sprite_SetBackgroundColor(uint16_t color) {
+  bg_color = ST7789_SWAP16(color);
+  ST7789_Sprite_SetBackground(sprite_bg_solid, NULL);
+}
+
+/**
+ * @brief 把精灵挂到精灵层并绘制
+ * @param z z序,数值大的在上层,相同z序时后加入的在上层
+ * @retval HAL_ERROR 精灵层已满,或精灵已经挂在精灵层上
+ */
+HAL_StatusTypeDef ST7789_Sprite_Add(ST7789_Sprite *s, uint8_t z) {
+  if (sprite_count >= ST7789_SPRITE_MAX || sprite_attached(s)) {
+    return HAL_ERROR;
+  }
+  if (bg_func == NULL) {
+    ST7789_Sprite_SetBackgroundColor(BLACK);
+  }
+
+  uint8_t i = sprite_count;
+  while (i > 0 && sprite_list[i - 1]->z > z) {
+    sprite_list[i] = sprite_list[i - 1];
+    i--;
+  }
+  sprite_list[i] = s;
+  sprite_count++;
+
+  s->z = z;
+  s->drawn = 0;
+  sprite_refresh(s);
+  return HAL_OK;
+}
+
+/**
+ * @brief 从精灵层移除精灵,并恢复其所在区域的背景
+ * @note 精灵的可见标志保持不变,再次加入时按原来的状态绘制
+ */
+void ST7789_Sprite_Remove(ST7789_Sprite *s) {
+  uint8_t i;
+  for (i = 0; i < sprite_count && sprite_list[i] != s; i++) {
+  }
+  if (i == sprite_count) {
+    return;
+  }
+  for (; i + 1 < sprite_count; i++) {
+    sprite_list[i] = sprite_list[i + 1];
+  }
+  sprite_count--;
+
+  uint8_t visible = s->flags & ST7789_SPRITE_VISIBLE;
+  s->flags &= ~ST7789_SPRITE_VISIBLE;
+  sprite_refresh(s);
+  s->flags |= visible;
+}
+
+/**
+ * @brief 移动精灵,只重绘新旧包围盒
+ */
+void ST7789_Sprite_MoveTo(ST7789_Sprite *s, int16_t x, int16_t y) {
+  if (s->drawn && s->x == x && s->y == y) {
+    return;
+  }
+  s->x = x;
+  s->y = y;
+  sprite_refresh(s);
+}
+
+/**
+ * @brief 显示或隐藏精灵
+ */
+void ST7789_Sprite_SetVisible(ST7789_Sprite *s, uint8_t visible) {
+  if (visible) {
+    s->flags |= ST7789_SPRITE_VISIBLE;
+  } else {
+    s->flags &= ~ST7789_SPRITE_VISIBLE;
+  }
+  sprite_refresh(s);
+}
+
+/**
+ * @brief 更换精灵图像(尺寸不变),用于动画帧切换
+ */
+void ST7789_Sprite_SetImage(ST7789_Sprite *s, const uint16_t *image) {
+  s->image = image;
+  sprite_refresh(s);
+}
+
+/**
+ * @brief 重绘屏幕上的一个矩形区域(背景+精灵)
+ * @note 背景内容变化后调用
+ */
+void ST7789_Sprite_Redraw(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
+  sprite_rect_t r = {x0, y0, x1, y1};
+
+  if (bg_func == NULL) {
+    ST7789_Sprite_SetBackgroundColor(BLACK);
+  }
+  if (r.x1 > ST7789_WIDTH - 1) r.x1 = ST7789_WIDTH - 1;
+  if (r.y1 > ST7789_HEIGHT - 1) r.y1 = ST7789_HEIGHT - 1;
+  if (r.x0 > r.x1 || r.y0 > r.y1) {
+    return;
+  }
+  sprite_compose(&r);
+}
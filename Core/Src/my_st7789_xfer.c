@@ -0,0 +1,268 @@
+/**
+ * @name         : my_st7789_xfer.c
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-19 13:05:32
+ * @brief        : ST7789 中断驱动的传输引擎实现
+ * 每个阶段是一次SPI DMA传输,HAL在DMA完成并等待BSY清零后调用HAL_SPI_TxCpltCallback,
+ * 此时切换DC再启动下一阶段是安全的
+ * @version      : V1.3
+ * V1.1 2026-10-19 18:10:42 等待队列时WFI睡眠,提交时唤醒面板
+ * V1.2 2026-10-19 21:05:49 与阻塞接口共用地址窗口影子缓存,跳过未变化的CASET/RASET阶段
+ * V1.3 2026-10-20 01:02:47 中断中推进事务的函数放入SRAM运行
+ */
+
+#include "my_st7789_xfer.h"
+#include "my_st7789_ll.h"
+#include "my_st7789_prof.h"
+
+/* 单次DMA最多65535字节,像素数据按偶数字节分段发送 */
+#define XFER_COPY_CHUNK_BYTES 0xFFFE
+
+typedef enum {
+  XFER_PHASE_CASET_CMD = 0,
+  XFER_PHASE_CASET_DATA,
+  XFER_PHASE_RASET_CMD,
+  XFER_PHASE_RASET_DATA,
+  XFER_PHASE_RAMWR_CMD,
+  XFER_PHASE_PAYLOAD,
+  XFER_PHASE_CMD,
+  XFER_PHASE_PARAM,
+  XFER_PHASE_DONE,
+} xfer_phase_t;
+
+static ST7789_Xfer xfer_queue[ST7789_XFER_QUEUE_LEN];
+static uint8_t xfer_head;
+static volatile uint8_t xfer_count;
+static volatile uint8_t xfer_active;
+
+/* 当前事务状态,只在中断中或关中断时修改 */
+static xfer_phase_t xfer_phase;
+static const uint8_t *xfer_src;
+static uint32_t xfer_remaining;
+
+/* DMA源缓冲区必须在传输期间保持有效,所以都放在静态区 */
+static uint8_t xfer_cmd;
+static uint8_t xfer_param[4];
+static uint16_t xfer_pattern[ST7789_XFER_FILL_CHUNK];
+
+static void xfer_tx(const uint8_t *data, uint16_t len, uint8_t kind) {
+  ST7789_PROF_BEGIN();
+  ST7789_BUS_START(kind, len, 1);
+  HAL_SPI_Transmit_DMA(&ST7789_SPI_PORT, (uint8_t *)data, len);
+  ST7789_PROF_BYTES(len);
+  ST7789_PROF_END(ST7789_PROF_XFER_DMA);
+}
+
+static void xfer_send_cmd(uint8_t cmd) {
+  xfer_cmd = cmd;
+  ST7789_DC_Clr();
+  xfer_tx(&xfer_cmd, 1, ST7789_BUS_CMD);
+}
+
+static void xfer_send_range(uint16_t start, uint16_t end) {
+  xfer_param[0] = start >> 8;
+  xfer_param[1] = start & 0xFF;
+  xfer_param[2] = end >> 8;
+  xfer_param[3] = end & 0xFF;
+  ST7789_DC_Set();
+  xfer_tx(xfer_param, sizeof(xfer_param), ST7789_BUS_PARAM);
+}
+
+/**
+ * @brief 准备数据阶段的数据源
+ */
+static void xfer_load_payload(const ST7789_Xfer *x) {
+  if (x->mode == ST7789_XFER_CMD) {
+    xfer_src = x->src;
+    xfer_remaining = x->count;
+  } else if (x->mode == ST7789_XFER_REPEAT) {
+    uint16_t c = ST7789_SWAP16(x->color);
+    for (uint16_t i = 0; i < ST7789_XFER_FILL_CHUNK; i++) {
+      xfer_pattern[i] = c;
+    }
+    xfer_src = (const uint8_t *)xfer_pattern;
+    xfer_remaining = x->count * 2;
+  } else {
+    xfer_src = x->src;
+    xfer_remaining = x->count * 2;
+  }
+}
+
+/**
+ * @brief 发送数据阶段的下一段
+ */
+static void xfer_send_chunk(const ST7789_Xfer *x) {
+  uint32_t limit = x->mode == ST7789_XFER_REPEAT ? sizeof(xfer_pattern) : XFER_COPY_CHUNK_BYTES;
+  uint16_t n = xfer_remaining > limit ? limit : xfer_remaining;
+  const uint8_t *p = xfer_src;
+
+  xfer_remaining -= n;
+  if (x->mode != ST7789_XFER_REPEAT) {
+    xfer_src += n;
+  }
+  ST7789_DC_Set();
+  xfer_tx(p, n, x->mode == ST7789_XFER_CMD ? ST7789_BUS_PARAM : ST7789_BUS_PIXEL);
+}
+
+/**
+ * @brief 启动当前阶段的传输
+ * @retval 0 当前事务已没有需要发送的内容
+ */
+static uint8_t xfer_send_phase(const ST7789_Xfer *x) {
+  switch (xfer_phase) {
+  case XFER_PHASE_CASET_CMD:
+    ST7789_BUS_WINDOW();
+    if (!st7789_window_same(ST7789_WIN_COL, x->x0 + X_SHIFT, x->x1 + X_SHIFT)) {
+      st7789_window_note_cmd(ST7789_CASET);
+      xfer_send_cmd(ST7789_CASET);
+      return 1;
+    }
+    xfer_phase = XFER_PHASE_RASET_CMD; // 列地址未变,跳过CASET
+    /* fall through */
+  case XFER_PHASE_RASET_CMD:
+    if (!st7789_window_same(ST7789_WIN_ROW, x->y0 + Y_SHIFT, x->y1 + Y_SHIFT)) {
+      st7789_window_note_cmd(ST7789_RASET);
+      xfer_send_cmd(ST7789_RASET);
+      return 1;
+    }
+    xfer_phase = XFER_PHASE_RAMWR_CMD;
+    /* fall through */
+  case XFER_PHASE_RAMWR_CMD:
+    xfer_send_cmd(ST7789_RAMWR);
+    return 1;
+  case XFER_PHASE_CASET_DATA:
+    xfer_send_range(x->x0 + X_SHIFT, x->x1 + X_SHIFT);
+    st7789_window_set(ST7789_WIN_COL, x->x0 + X_SHIFT, x->x1 + X_SHIFT);
+    return 1;
+  case XFER_PHASE_RASET_DATA:
+    xfer_send_range(x->y0 + Y_SHIFT, x->y1 + Y_SHIFT);
+    st7789_window_set(ST7789_WIN_ROW, x->y0 + Y_SHIFT, x->y1 + Y_SHIFT);
+    return 1;
+  case XFER_PHASE_CMD:
+    st7789_window_note_cmd(x->cmd);
+    xfer_send_cmd(x->cmd);
+    return 1;
+  case XFER_PHASE_PAYLOAD:
+  case XFER_PHASE_PARAM:
+    if (xfer_remaining == 0) {
+      return 0;
+    }
+    xfer_send_chunk(x);
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+/**
+ * @brief 当前阶段结束后进入下一阶段
+ */
+static void xfer_advance(const ST7789_Xfer *x) {
+  switch (xfer_phase) {
+  case XFER_PHASE_PAYLOAD:
+  case XFER_PHASE_PARAM:
+    if (xfer_remaining == 0) {
+      xfer_phase = XFER_PHASE_DONE;
+    }
+    break;
+  case XFER_PHASE_RAMWR_CMD:
+  case XFER_PHASE_CMD:
+    xfer_phase++;
+    xfer_load_payload(x);
+    break;
+  default:
+    xfer_phase++;
+    break;
+  }
+}
+
+/**
+ * @brief 从队首开始推进,直到启动一次DMA或队列为空
+ * @note 在中断中或关中断时调用
+ */
+static ST7789_RAMFUNC void xfer_pump(void) {
+  while (xfer_count > 0) {
+    ST7789_Xfer *x = &xfer_queue[xfer_head];
+
+    if (!xfer_active) {
+      xfer_active = 1;
+      xfer_phase = x->mode == ST7789_XFER_CMD ? XFER_PHASE_CMD : XFER_PHASE_CASET_CMD;
+    } else {
+      xfer_advance(x);
+    }
+
+    if (xfer_phase != XFER_PHASE_DONE && xfer_send_phase(x)) {
+      return;
+    }
+
+    /* 当前事务结束,先出队再回调,回调中可以继续提交 */
+    ST7789_XferCallback done = x->done;
+    void *ctx = x->ctx;
+    xfer_head = (xfer_head + 1) % ST7789_XFER_QUEUE_LEN;
+    xfer_count--;
+    xfer_active = 0;
+    if (done) {
+      done(ctx);
+    }
+    if (xfer_active) {
+      return; // 回调中提交的事务已经启动
+    }
+  }
+}
+
+/**
+ * @brief SPI发送完成回调,在DMA中断中推进当前事务
+ */
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi) {
+  if (hspi != &ST7789_SPI_PORT || !xfer_active) {
+    return;
+  }
+  ST7789_BUS_DONE();
+  xfer_pump();
+}
+
+/**
+ * @brief 提交一个事务,立即返回
+ * @retval HAL_BUSY 队列已满
+ * @note 可以在主循环或完成回调中调用;不要在其他中断中调用,
+ *       否则可能打断正在进行的阻塞发送
+ */
+HAL_StatusTypeDef ST7789_Xfer_Submit(const ST7789_Xfer *xfer) {
+  ST7789_PROF_BEGIN();
+  st7789_pixel_flush();
+  st7789_pm_activity();
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+
+  if (xfer_count >= ST7789_XFER_QUEUE_LEN) {
+    __set_PRIMASK(primask);
+    ST7789_PROF_END(ST7789_PROF_XFER_SUBMIT);
+    return HAL_BUSY;
+  }
+  xfer_queue[(xfer_head + xfer_count) % ST7789_XFER_QUEUE_LEN] = *xfer;
+  xfer_count++;
+
+  if (!xfer_active) {
+    xfer_pump();
+  }
+
+  __set_PRIMASK(primask);
+  ST7789_PROF_END(ST7789_PROF_XFER_SUBMIT);
+  return HAL_OK;
+}
+
+/**
+ * @brief 队列中是否还有未完成的事务
+ */
+uint8_t ST7789_Xfer_IsBusy(void) {
+  return xfer_count > 0;
+}
+
+/**
+ * @brief 等待队列中所有事务完成
+ */
+void ST7789_Xfer_Wait(void) {
+  while (xfer_count > 0) {
+    ST7789_SLEEP_WHILE(xfer_count > 0);
+  }
+}
@@ -0,0 +1,664 @@
+/**
+ * @name         : check.c
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-20 06:10:42
+ * @brief        : ST7789 仿真回归检查
+ * 在虚拟面板上运行有代表性的绘制操作,逐项比较传输量预算(ST7789_Sim_CheckBudget)和画面结果;
+ * 任何一项失败时返回非0,CI中直接作为测试运行
+ * 预算取当前实现的实测值:改动让传输次数或字节数变多时检查失败,确实需要时同时修改这里的预算
+ * 整个检查运行两遍,第二遍DMA完成中断延后到WFI时投递,模拟硬件上传输需要时间
+ * @version      : V1.15
+ * V1.1 2026-10-20 08:02:36 检查内存池的重复释放和行缓冲归还
+ * V1.2 2026-10-20 09:02:27 检查CRC仿真不漏算与当前结果相同的写入
+ * V1.3 2026-10-20 09:20:53 检查任务完成回调占满传输队列时调度器不会停住
+ * V1.4 2026-10-20 09:41:36 检查合成器由M2M DMA填充的底色
+ * V1.5 2026-10-20 10:05:14 重复释放检查在另一块仍被占用时进行
+ * V1.6 2026-10-20 10:24:48 增加显示列表的合并和传输队列占满时的回放检查
+ * V1.7 2026-10-20 10:43:17 检查初始化时的像素内核自检结果
+ * V1.8 2026-10-20 11:02:39 检查条带缓冲出现在内存区的"tile"池中
+ * V1.9 2026-10-20 11:21:06 检查精灵的色键,遮罩,移动,重复加入和移除
+ * V1.10 2026-10-20 11:38:52 检查批量点,矩形和水平线的画面结果
+ * V1.11 2026-10-20 11:55:14 检查仿射绘制的像素,90度旋转与ST7789_BLIT_ROT90逐像素比较
+ * V1.12 2026-10-20 12:10:33 检查帧缓冲初始化之前的调用是空操作
+ * V1.13 2026-10-20 12:26:45 检查面板睡眠的自动唤醒,SLPIN/SLPOUT间隔和空闲超时
+ * V1.14 2026-10-20 12:44:20 检查背光明度曲线两端和渐变过程中写入的占空比
+ * V1.15 2026-10-20 12:58:09 检查4bpp低分辨率帧缓冲刷新后每个逻辑像素在屏幕上为2x2
+ */
+
+#include "st7789_sim.h"
+#include "my_st7789_2.h"
+#include "my_st7789_affine.h"
+#include "my_st7789_arena.h"
+#include "my_st7789_backlight.h"
+#include "my_st7789_batch.h"
+#include "my_st7789_blit.h"
+#include "my_st7789_clip.h"
+#include "my_st7789_comp.h"
+#include "my_st7789_dlist.h"
+#include "my_st7789_fb.h"
+#include "my_st7789_kern.h"
+#include "my_st7789_pm.h"
+#include "my_st7789_sched.h"
+#include "my_st7789_shader.h"
+#include "my_st7789_sprite.h"
+#include "my_st7789_tile.h"
+#include "my_st7789_xfer.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/* 预算:SPI发送次数,命令字节,参数字节,像素字节,CASET,RASET,RAMWR;dropped和时序违例始终要求为0 */
+#define CHECK_BUDGET(xfers, cmd, param, pixel, caset_, raset_, ramwr_)                                          \
+  ((ST7789_SimStats){.transactions = (xfers), .cmd_bytes = (cmd), .param_bytes = (param), .pixel_bytes = (pixel), \
+                     .caset = (caset_), .raset = (raset_), .ramwr = (ramwr_)})
+
+static int check_fail;
+static ST7789_SimStats check_mark;
+
+static uint16_t check_img[32 * 32];
+static uint16_t check_glyph[8 * 16];
+static uint8_t check_fb_mem[ST7789_FB_SIZE(1)];
+static uint16_t check_spr[8 * 8];
+static uint8_t check_spr_mask[8];
+
+/**
+ * @brief 开始统计一个操作
+ */
+static void check_begin(void) {
+  check_mark = ST7789_Sim_Stats();
+}
+
+/**
+ * @brief 结束统计并与预算比较,预算中为0的项不检查
+ */
+static void check_budget(const char *label, ST7789_SimStats max) {
+  ST7789_SimStats now = ST7789_Sim_Stats();
+  ST7789_SimStats d = ST7789_Sim_Diff(&now, &check_mark);
+
+  ST7789_Sim_PrintStats(label, &d);
+  check_fail += ST7789_Sim_CheckBudget(label, &d, &max);
+}
+
+/**
+ * @brief 结束统计,要求SPI上没有任何传输
+ */
+static void check_silent(const char *label) {
+  ST7789_SimStats now = ST7789_Sim_Stats();
+  ST7789_SimStats d = ST7789_Sim_Diff(&now, &check_mark);
+
+  ST7789_Sim_PrintStats(label, &d);
+  if (d.transactions != 0) {
+    printf("%s: %lu transfers, expected none\n", label, (unsigned long)d.transactions);
+    check_fail++;
+  }
+}
+
+/**
+ * @brief 检查一个屏幕像素(ST7789_ROTATION为2时屏幕坐标即GRAM坐标)
+ */
+static void check_pixel(const char *label, uint16_t x, uint16_t y, uint16_t expect) {
+  uint16_t p = ST7789_Sim_Pixel(x, y);
+
+  if (p != expect) {
+    printf("%s: pixel (%u,%u) = %04x, expected %04x\n", label, x, y, p, expect);
+    check_fail++;
+  }
+}
+
+/* 条带回调:整屏竖条纹,帧号在ctx中 */
+static void check_band(uint16_t y, uint16_t h, uint16_t *out, void *ctx) {
+  uint16_t frame = *(const uint16_t *)ctx;
+
+  for (uint32_t i = 0; i < (uint32_t)ST7789_WIDTH * h; i++) {
+    uint16_t x = i % ST7789_WIDTH;
+    out[i] = ST7789_SWAP16((x / 16 + frame) & 1 ? 0x001F : 0xF800);
+  }
+  (void)y;
+}
+
+/* 内存区输出回调:检查"line"内存池所有行缓冲都已归还,没有分配失败 */
+static uint8_t check_tile_pool;
+
+static void check_arena(const char *line) {
+  unsigned block, count, used, peak;
+  unsigned long fails;
+
+  if (strncmp(line, "line ", 5) == 0 && sscanf(line + 5, "%u %u %u %u %lu", &block, &count, &used, &peak, &fails) == 5 &&
+      (used != 0 || fails != 0)) {
+    printf("line pool: %u in use, %lu failures\n", used, fails);
+    check_fail++;
+  }
+  if (strncmp(line, "tile ", 5) == 0 && sscanf(line + 5, "%u %u %u %u %lu", &block, &count, &used, &peak, &fails) == 5) {
+    check_tile_pool = 1;
+    if (block != ST7789_WIDTH * ST7789_TILE_H * 2 || used != 1) {
+      printf("tile pool: block %u, %u in use\n", block, used);
+      check_fail++;
+    }
+  }
+}
+
+/* 任务完成回调:用异步填充占满传输队列 */
+static void check_job_flood(void *ctx, uint8_t late) {
+  uint8_t *n = ctx;
+
+  while (ST7789_Fill_Async(200, 220, 209, 229, 0x07E0, NULL, NULL) != ST7789_HANDLE_NONE) {
+    (*n)++;
+  }
+}
+
+static void check_run(void) {
+  ST7789_Sim_Reset();
+  for (uint16_t i = 0; i < 32 * 32; i++) {
+    check_img[i] = ST7789_SWAP16((uint16_t)(i * 37 + 1));
+  }
+  for (uint16_t i = 0; i < 8 * 16; i++) {
+    check_glyph[i] = ST7789_SWAP16(i & 1 ? 0xFFFF : 0x0000);
+  }
+
+  check_begin();
+  ST7789_Init();
+  ST7789_WaitIdle();
+  check_budget("init", CHECK_BUDGET(486, 20, 52, 115200, 1, 1, 1));
+  /* 主机上像素内核就是C实现,这里至少保证Init中的自检被调用过并且通过 */
+  if (ST7789_Kern_SelfTestErrors() != 0) {
+    printf("kern: self-test at init reported %lu errors\n", (unsigned long)ST7789_Kern_SelfTestErrors());
+    check_fail++;
+  }
+
+  check_begin();
+  ST7789_Fill_Color(0x0000);
+  check_budget("fill_color", CHECK_BUDGET(451, 1, 0, 115200, 0, 0, 1));
+
+  check_begin();
+  ST7789_Fill(10, 10, 49, 29, 0xF800);
+  check_budget("fill", CHECK_BUDGET(12, 3, 8, 1600, 1, 1, 1));
+  check_pixel("fill", 10, 10, 0xF800);
+  check_pixel("fill", 49, 29, 0xF800);
+  check_pixel("fill", 50, 29, 0x0000);
+
+  check_begin();
+  ST7789_DrawImage(100, 100, 32, 32, check_img);
+  check_budget("image", CHECK_BUDGET(6, 3, 8, 2048, 1, 1, 1));
+  check_pixel("image", 101, 100, 38);
+
+  /* 右侧超出屏幕:可见部分逐行从图片发送 */
+  check_begin();
+  ST7789_DrawImage(224, 100, 32, 32, check_img);
+  check_budget("image_clipped", CHECK_BUDGET(35, 2, 4, 1024, 1, 1, 1));
+  check_pixel("image_clipped", 225, 101, 33 * 37 + 1);
+
+  /* 一行文字:30个8x16字形,行地址不变时只发送CASET */
+  check_begin();
+  for (uint16_t i = 0; i < 30; i++) {
+    ST7789_DrawImage(i * 8, 200, 8, 16, check_glyph);
+  }
+  check_budget("glyph_row", CHECK_BUDGET(122, 61, 124, 7680, 30, 1, 30));
+
+  /* 逐点画240x100:写合并缓冲把连续的点合并成少量窗口 */
+  check_begin();
+  for (uint16_t y = 0; y < 100; y++) {
+    for (uint16_t x = 0; x < 240; x++) {
+      ST7789_DrawPixel(x, y, 0x07E0);
+    }
+  }
+  ST7789_Flush();
+  check_budget("pixel_run", CHECK_BUDGET(1102, 201, 404, 48000, 1, 100, 100));
+  check_pixel("pixel_run", 239, 99, 0x07E0);
+
+  /* 写合并缓冲中还有点时设置新窗口:先冲刷,再比较窗口缓存 */
+  ST7789_Fill_Color(0xFFFF);
+  ST7789_Sprite_SetBackgroundColor(0x001F);
+  check_begin();
+  ST7789_DrawPixel(10, 5, 0xF800);
+  ST7789_DrawPixel(11, 5, 0xF800);
+  ST7789_Sprite_Redraw(0, 100, 239, 100);
+  check_budget("pixels_then_window", CHECK_BUDGET(12, 6, 16, 484, 2, 2, 2));
+  check_pixel("pixels_then_window", 11, 5, 0xF800);
+  check_pixel("pixels_then_window", 0, 100, 0x001F);
+  check_pixel("pixels_then_window", 100, 100, 0x001F);
+  check_pixel("pixels_then_window", 239, 100, 0x001F);
+  ST7789_Fill_Color(0x0000);
+
+  check_begin();
+  for (uint16_t i = 0; i < 8; i++) {
+    ST7789_Fill_Async(i * 30, 150, i * 30 + 19, 159, i & 1 ? 0x001F : 0xFFE0, NULL, NULL);
+  }
+  ST7789_WaitIdle();
+  check_budget("fill_async", CHECK_BUDGET(42, 17, 36, 3200, 8, 1, 8));
+  check_pixel("fill_async", 30, 150, 0x001F);
+
+  /* 阻塞绘制紧跟在异步队列之后:窗口缓存要在队列发完之后再比较,否则会跳过被队列改掉的CASET */
+  check_begin();
+  ST7789_Fill_Async(0, 0, 9, 239, 0xF800, NULL, NULL);
+  ST7789_Fill_Async(100, 0, 109, 9, 0xF800, NULL, NULL);
+  ST7789_Sim_RunDma(2); // 第一个事务的CASET已发出,缓存中的列范围为0~9
+  ST7789_DrawImage(0, 200, 10, 10, check_img);
+  check_budget("async_then_image", CHECK_BUDGET(36, 9, 24, 5200, 3, 3, 3));
+  check_pixel("async_then_image", 0, 200, ST7789_SWAP16(check_img[0]));
+  check_pixel("async_then_image", 100, 200, 0x0000);
+
+  {
+    ST7789_Rect rects[4] = {
+        {0, 170, 9, 179, 0xF800},
+        {10, 170, 19, 179, 0xF800},
+        {20, 170, 29, 179, 0xF800},
+        {0, 180, 29, 189, 0xF800},
+    };
+    check_begin();
+    ST7789_FillRects(rects, 4);
+    ST7789_WaitIdle();
+    check_budget("fill_rects", CHECK_BUDGET(10, 3, 8, 1200, 1, 1, 1));
+    check_pixel("fill_rects", 15, 175, 0xF800);
+    check_pixel("fill_rects", 29, 189, 0xF800);
+  }
+
+  /* 批量点:一行行程,一列,(105,230)出现三次,以数组中最后一个为准 */
+  {
+    ST7789_Point pts[17];
+    uint16_t n = 0;
+    for (uint16_t x = 100; x < 110; x++) {
+      pts[n++] = (ST7789_Point){x, 230, 0xF800};
+      if (x == 106) {
+        pts[n++] = (ST7789_Point){105, 230, 0x001F};
+      }
+    }
+    for (uint16_t y = 225; y < 230; y++) {
+      pts[n++] = (ST7789_Point){120, y, 0x07E0};
+    }
+    pts[n++] = (ST7789_Point){105, 230, 0xFFE0};
+    check_begin();
+    ST7789_DrawPoints(pts, n);
+    check_budget("draw_points", CHECK_BUDGET(12, 6, 16, 30, 2, 2, 2));
+    check_pixel("draw_points", 100, 230, 0xF800);
+    check_pixel("draw_points", 109, 230, 0xF800);
+    check_pixel("draw_points", 105, 230, 0xFFE0);
+    check_pixel("draw_points", 120, 225, 0x07E0);
+    check_pixel("draw_points", 120, 229, 0x07E0);
+  }
+
+  /* 批量水平线:同一行相接的合并,上下相接且等宽的合并成一个矩形 */
+  {
+    ST7789_Span spans[6] = {
+        {140, 225, 10, 0x07FF}, {150, 225, 10, 0x07FF}, {140, 226, 20, 0x07FF},
+        {140, 227, 20, 0x07FF}, {140, 228, 20, 0x07FF}, {140, 229, 20, 0x07FF},
+    };
+    check_begin();
+    ST7789_DrawHLines(spans, 6);
+    ST7789_WaitIdle();
+    check_budget("draw_hlines", CHECK_BUDGET(4, 2, 4, 200, 1, 1, 1));
+    check_pixel("draw_hlines", 140, 225, 0x07FF);
+    check_pixel("draw_hlines", 159, 229, 0x07FF);
+    check_pixel("draw_hlines", 160, 229, 0x0000);
+  }
+
+  /* 帧缓冲初始化之前(只有第一遍)的调用都是空操作 */
+  if (ST7789_FB_Height() == 0) {
+    check_begin();
+    ST7789_FB_MarkDirty(0, 0xFFFF);
+    ST7789_FB_SetPalette((const uint16_t[]){0x0000, 0xFFFF}, 2);
+    ST7789_FB_Clear(1);
+    ST7789_FB_FillRect(0, 0, 9, 9, 1);
+    ST7789_FB_Flush();
+    check_silent("fb_uninit");
+  }
+
+  /* 1bpp帧缓冲只发送脏行 */
+  ST7789_FB_Init(1, check_fb_mem, sizeof(check_fb_mem));
+  ST7789_FB_SetPalette((const uint16_t[]){0x0000, 0xFFFF}, 2);
+  ST7789_FB_Clear(0);
+  ST7789_FB_Flush();
+  check_begin();
+  ST7789_FB_FillRect(20, 40, 59, 47, 1);
+  ST7789_FB_Flush();
+  check_budget("fb_dirty_rows", CHECK_BUDGET(11, 2, 4, 3840, 0, 1, 1));
+  check_pixel("fb_dirty_rows", 20, 40, 0xFFFF);
+
+  /* 4bpp低分辨率帧缓冲:每个逻辑像素在屏幕上是2x2,每个脏逻辑行发送两行 */
+  if (ST7789_FB_Init2x(4, check_fb_mem, sizeof(check_fb_mem)) != HAL_OK) {
+    printf("fb_2x: init failed\n");
+    check_fail++;
+  }
+  ST7789_FB_SetPalette((const uint16_t[]){0x0000, 0xF800, 0x07E0, 0x001F}, 4);
+  ST7789_FB_Flush();
+  check_begin();
+  ST7789_FB_SetPixel(10, 20, 1);
+  ST7789_FB_SetPixel(11, 20, 2);
+  ST7789_FB_FillRect(50, 60, 52, 61, 3);
+  ST7789_FB_Flush();
+  check_budget("fb_2x", CHECK_BUDGET(12, 4, 8, 2880, 0, 2, 2));
+  check_pixel("fb_2x", 19, 40, 0x0000);
+  check_pixel("fb_2x", 20, 40, 0xF800);
+  check_pixel("fb_2x", 21, 41, 0xF800);
+  check_pixel("fb_2x", 22, 41, 0x07E0);
+  check_pixel("fb_2x", 23, 40, 0x07E0);
+  check_pixel("fb_2x", 24, 40, 0x0000);
+  check_pixel("fb_2x", 20, 42, 0x0000);
+  check_pixel("fb_2x", 100, 120, 0x001F);
+  check_pixel("fb_2x", 105, 123, 0x001F);
+  check_pixel("fb_2x", 106, 123, 0x0000);
+  check_pixel("fb_2x", 239, 239, 0x0000);
+
+  {
+    ST7789_LinearGradient g = {0, 0, 239, 0, 0xF800, 0x001F, 0};
+    check_begin();
+    ST7789_Shade(0, 0, 239, 239, ST7789_Shader_Linear, &g);
+    check_budget("shade", CHECK_BUDGET(243, 2, 4, 115200, 0, 1, 1));
+    check_pixel("shade", 0, 10, 0xF800);
+    check_pixel("shade", 239, 10, 0x001F);
+  }
+
+  /* 径向渐变:半径以外(含抖动)必须是纯c1 */
+  {
+    ST7789_RadialGradient g = {120, 120, 100, 0xF800, 0x001F, 1};
+    uint32_t off = 0;
+    check_begin();
+    ST7789_Shade(0, 0, 239, 239, ST7789_Shader_Radial, &g);
+    check_budget("shade_radial", CHECK_BUDGET(243, 2, 4, 115200, 0, 1, 1));
+    for (uint16_t y = 0; y < 240; y++) {
+      for (uint16_t x = 0; x < 240; x++) {
+        int32_t dx = x - 120, dy = y - 120;
+        if (dx * dx + dy * dy >= 100 * 100 && ST7789_Sim_Pixel(x, y) != 0x001F) {
+          off++;
+        }
+      }
+    }
+    if (off) {
+      printf("shade_radial: %lu pixels outside the radius are not c1\n", (unsigned long)off);
+      check_fail++;
+    }
+    check_pixel("shade_radial", 120, 120, 0xF800);
+  }
+
+  {
+    ST7789_Layer bg, icon;
+    ST7789_Layer_InitFill(&bg, 0, 0, 240, 240, 0x0000);
+    ST7789_Layer_InitImage(&icon, 50, 50, 32, 32, check_img);
+    ST7789_Comp_SetLayer(0, &bg);
+    ST7789_Comp_SetLayer(1, &icon);
+    check_begin();
+    ST7789_Comp_Render(40, 40, 99, 99);
+    check_budget("comp", CHECK_BUDGET(65, 3, 8, 7200, 1, 1, 1));
+    check_pixel("comp", 51, 50, 38);
+    check_pixel("comp", 40, 40, 0x0000);
+    ST7789_Comp_SetLayer(0, NULL);
+
+    /* 没有底层:行中图标以外的部分是底色,由M2M DMA在后台填充 */
+    ST7789_Comp_SetBase(0x07E0);
+    check_begin();
+    ST7789_Comp_Render(0, 40, 99, 59);
+    check_budget("comp_base", CHECK_BUDGET(25, 3, 8, 4000, 1, 1, 1));
+    check_pixel("comp_base", 0, 55, 0x07E0);
+    check_pixel("comp_base", 99, 55, 0x07E0);
+    check_pixel("comp_base", 51, 55, ST7789_SWAP16(check_img[5 * 32 + 1]));
+    ST7789_Comp_SetBase(0x0000);
+    ST7789_Comp_SetLayer(1, NULL);
+  }
+
+  /* 图块差分:第二帧相同,不发送任何像素 */
+  {
+    uint16_t frame = 0;
+    ST7789_Tile_Invalidate();
+    ST7789_Tile_Render(check_band, &frame);
+    check_begin();
+    ST7789_Tile_Render(check_band, &frame);
+    check_silent("tile_same");
+    frame = 1;
+    check_begin();
+    ST7789_Tile_Render(check_band, &frame);
+    check_budget("tile_changed", CHECK_BUDGET(285, 30, 60, 115200, 0, 15, 15));
+    check_pixel("tile_changed", 0, 0, 0x001F);
+  }
+
+  /* 显示列表:同色相邻的填充合并为一个窗口 */
+  check_begin();
+  ST7789_DList_Begin();
+  ST7789_DList_Fill(0, 180, 19, 189, 0xF800);
+  ST7789_DList_Fill(20, 180, 39, 189, 0xF800);
+  ST7789_DList_Submit();
+  ST7789_DList_Wait();
+  check_budget("dlist_merge", CHECK_BUDGET(9, 3, 8, 800, 1, 1, 1));
+  check_pixel("dlist_merge", 39, 189, 0xF800);
+
+  /* 显示列表:提交时传输队列被异步填充占满,回放仍要完成,ST7789_DList_Wait不能卡住 */
+  for (uint8_t i = 0; i < ST7789_XFER_QUEUE_LEN; i++) { // DMA立即完成时队列不会满,次数有限
+    ST7789_Fill_Async(200, 180, 209, 189, 0x07E0, NULL, NULL);
+  }
+  ST7789_DList_Begin();
+  ST7789_DList_Fill(40, 180, 59, 189, 0x001F);
+  ST7789_DList_Submit();
+  ST7789_WaitIdle();
+  if (ST7789_DList_IsBusy()) {
+    printf("dlist_full_queue: still busy after ST7789_WaitIdle\n");
+    check_fail++;
+  }
+  ST7789_DList_Wait();
+  check_pixel("dlist_full_queue", 59, 189, 0x001F);
+  check_pixel("dlist_full_queue", 209, 189, 0x07E0);
+
+  /* 调度器:第一个任务的完成回调占满传输队列,第二个任务仍要发送完,ST7789_Sched_Wait不能卡住 */
+  {
+    uint8_t flood = 0;
+    ST7789_Job a = {.x = 0, .y = 210, .w = 20, .h = 20, .color = 0xF800, .priority = ST7789_PRIO_URGENT,
+                    .done = check_job_flood, .ctx = &flood};
+    ST7789_Job b = {.x = 20, .y = 210, .w = 20, .h = 20, .color = 0x001F, .priority = ST7789_PRIO_NORMAL};
+    ST7789_Sched_Submit(&a);
+    ST7789_Sched_Submit(&b);
+    ST7789_Sched_Wait();
+    ST7789_WaitIdle();
+    if (flood == 0) {
+      printf("sched_flood: done callback did not run\n");
+      check_fail++;
+    }
+    check_pixel("sched_flood", 0, 210, 0xF800);
+    check_pixel("sched_flood", 39, 229, 0x001F);
+    check_pixel("sched_flood", 209, 229, 0x07E0);
+  }
+
+  check_begin();
+  ST7789_Blit(0, 0, 32, 32, check_img, ST7789_BLIT_ROT90);
+  check_budget("blit_rot90", CHECK_BUDGET(10, 5, 10, 2048, 1, 1, 1));
+  check_pixel("blit_rot90", 31, 1, 38); // 源(1,0)旋转后在(31,1)
+
+  {
+    ST7789_Affine t;
+    ST7789_Affine_Init(&t, check_img, 32, 32);
+    ST7789_Affine_RotScale(&t, ST7789_AFFINE_TURN / 8, 0x10000, 16 << 16, 16 << 16, 120, 120);
+    check_begin();
+    ST7789_Affine_Draw(&t);
+    check_budget("affine_45", CHECK_BUDGET(51, 3, 8, 4232, 1, 1, 1));
+    check_pixel("affine_45", 120, 120, ST7789_SWAP16(check_img[16 * 32 + 16])); // 支点
+    check_pixel("affine_45", t.x0, t.y0, 0x0000);                               // 包围盒的角在源图片外
+
+    /* 绕中心顺时针转90度,结果应与ST7789_BLIT_ROT90逐像素相同 */
+    ST7789_Affine_RotScale(&t, ST7789_AFFINE_TURN / 4, 0x10000, 16 << 16, 16 << 16, 56, 16);
+    check_begin();
+    ST7789_Affine_Draw(&t);
+    check_budget("affine_90", CHECK_BUDGET(37, 3, 8, 2048, 1, 1, 1));
+    uint16_t diff = 0;
+    for (uint16_t y = 0; y < 32; y++) {
+      for (uint16_t x = 0; x < 32; x++) {
+        diff += ST7789_Sim_Pixel(40 + x, y) != ST7789_Sim_Pixel(x, y);
+      }
+    }
+    if (diff != 0) {
+      printf("affine_90: %u pixels differ from blit_rot90\n", diff);
+      check_fail++;
+    }
+  }
+
+  /* 精灵:色键和遮罩透明,移动后旧位置恢复背景,重复加入被拒绝,移除时保留可见标志 */
+  {
+    ST7789_Sprite a, b;
+    for (uint16_t i = 0; i < 8 * 8; i++) {
+      check_spr[i] = ST7789_SWAP16(i % 8 == 0 ? 0x07E0 : 0xF800); // 第0列为色键
+    }
+    memset(check_spr_mask, 0xF0, sizeof(check_spr_mask)); // 每行左4列不透明
+    ST7789_Sprite_SetBackgroundColor(0x001F);
+    ST7789_Sprite_Init(&a, 8, 8, check_spr);
+    ST7789_Sprite_SetColorKey(&a, 0x07E0);
+    ST7789_Sprite_MoveTo(&a, 40, 200);
+    ST7789_Sprite_Init(&b, 8, 8, check_img);
+    ST7789_Sprite_SetMask(&b, check_spr_mask);
+    ST7789_Sprite_MoveTo(&b, 62, 200);
+
+    if (ST7789_Sprite_Add(&a, 1) != HAL_OK || ST7789_Sprite_Add(&a, 1) != HAL_ERROR) {
+      printf("sprite: second add of the same sprite was not rejected\n");
+      check_fail++;
+    }
+    check_pixel("sprite_key", 40, 200, 0x001F);
+    check_pixel("sprite_key", 41, 200, 0xF800);
+    check_pixel("sprite_key", 47, 207, 0xF800);
+
+    check_begin();
+    ST7789_Sprite_MoveTo(&a, 60, 200);
+    check_budget("sprite_move", CHECK_BUDGET(20, 3, 4, 256, 1, 1, 2)); // 相距较远,新旧位置分两个窗口
+    check_pixel("sprite_move", 41, 200, 0x001F);
+    check_pixel("sprite_move", 60, 200, 0x001F);
+    check_pixel("sprite_move", 61, 200, 0xF800);
+
+    ST7789_Sprite_Add(&b, 2);
+    check_pixel("sprite_mask", 62, 200, ST7789_SWAP16(check_img[0]));
+    check_pixel("sprite_mask", 65, 207, ST7789_SWAP16(check_img[7 * 8 + 3]));
+    check_pixel("sprite_mask", 66, 200, 0xF800); // 遮罩透明处露出下层精灵
+    check_pixel("sprite_mask", 68, 200, 0x001F);
+
+    ST7789_Sprite_Remove(&b);
+    check_pixel("sprite_remove", 62, 200, 0xF800);
+    check_pixel("sprite_remove", 68, 200, 0x001F);
+    ST7789_Sprite_SetVisible(&a, 0);
+    ST7789_Sprite_Remove(&a);
+    check_pixel("sprite_remove", 61, 200, 0x001F);
+    if (!(b.flags & ST7789_SPRITE_VISIBLE) || (a.flags & ST7789_SPRITE_VISIBLE)) {
+      printf("sprite: remove changed the visible flag\n");
+      check_fail++;
+    }
+  }
+
+  /* 完全被裁掉的绘制不发送任何字节 */
+  ST7789_Clip_PushViewport(0, 0, 10, 10);
+  check_begin();
+  ST7789_Clip_Fill(20, 20, 40, 40, 0xFFFF);
+  ST7789_Clip_DrawImage(-40, 0, 32, 32, check_img);
+  ST7789_Flush();
+  check_silent("culled");
+  ST7789_Clip_Pop();
+
+  /* 面板睡眠:睡眠后马上绘制和马上再睡眠,驱动都要补足SLPIN/SLPOUT之间的120ms;空闲超时后自动睡眠 */
+  {
+    uint8_t level = ST7789_Backlight_Get();
+    uint64_t t0 = ST7789_Sim_TimeUs();
+    check_begin();
+    ST7789_PM_Sleep();
+    if (!ST7789_Sim_Panel()->sleeping || ST7789_Backlight_Get() != 0) {
+      printf("pm: panel awake or backlight on after ST7789_PM_Sleep\n");
+      check_fail++;
+    }
+    ST7789_Fill(0, 236, 19, 239, 0xF81F); // 自动唤醒
+    if (ST7789_Sim_Panel()->sleeping || ST7789_PM_IsSleeping() || ST7789_Backlight_Get() != level) {
+      printf("pm: drawing did not wake the panel and restore the backlight\n");
+      check_fail++;
+    }
+    ST7789_PM_Sleep();
+    ST7789_PM_Wake();
+    check_budget("pm_spacing", CHECK_BUDGET(10, 7, 8, 160, 1, 1, 1)); // 时序违例始终要求为0
+    check_pixel("pm_spacing", 19, 239, 0xF81F);
+    if (ST7789_Sim_TimeUs() - t0 < 3 * ST7789_PM_SLEEP_SPACING_MS * 1000u) {
+      printf("pm: three sleep/wake changes took %lu us\n", (unsigned long)(ST7789_Sim_TimeUs() - t0));
+      check_fail++;
+    }
+
+    ST7789_PM_SetTimeout(50);
+    ST7789_Fill(0, 236, 19, 239, 0x07FF);
+    ST7789_PM_Poll();
+    uint8_t early = ST7789_PM_IsSleeping();
+    HAL_Delay(50);
+    ST7789_PM_Poll();
+    if (early || !ST7789_PM_IsSleeping() || !ST7789_Sim_Panel()->sleeping) {
+      printf("pm: idle timeout slept %s\n", early ? "too early" : "never");
+      check_fail++;
+    }
+    ST7789_PM_SetTimeout(0);
+    ST7789_PM_Wake();
+    check_pixel("pm_timeout", 0, 236, 0x07FF);
+  }
+
+  /* 背光:明度曲线两端为全灭和全亮且单调;渐变表逐级写入TIM2->CCR3,中途的占空比对应当时的等级 */
+  {
+    uint16_t prev = 0;
+    for (uint16_t lv = 0; lv <= 255; lv++) {
+      uint16_t g = ST7789_Backlight_Gamma(lv);
+      if (g < prev) {
+        printf("backlight: gamma(%u) = %u below gamma(%u) = %u\n", lv, g, lv - 1, prev);
+        check_fail++;
+        break;
+      }
+      prev = g;
+    }
+    if (ST7789_Backlight_Gamma(0) != 0 || ST7789_Backlight_Gamma(255) != ST7789_BL_PWM_PERIOD ||
+        ST7789_Backlight_Gamma(128) > ST7789_BL_PWM_PERIOD / 4) {
+      printf("backlight: gamma endpoints %u/%u, midpoint %u\n", ST7789_Backlight_Gamma(0),
+             ST7789_Backlight_Gamma(255), ST7789_Backlight_Gamma(128));
+      check_fail++;
+    }
+
+    ST7789_Backlight_Set(0);
+    ST7789_Backlight_FadeTo(255, 320); // 32级,每级10ms
+    HAL_Delay(160);
+    uint8_t mid = ST7789_Backlight_Get();
+    uint16_t mid_duty = TIM2->CCR3;
+    HAL_Delay(170);
+    if (mid != 127 || mid_duty != ST7789_Backlight_Gamma(mid) || ST7789_Backlight_IsFading() ||
+        ST7789_Backlight_Get() != 255 || TIM2->CCR3 != ST7789_BL_PWM_PERIOD) {
+      printf("backlight: fade mid level %u duty %u, end level %u duty %lu\n", mid, mid_duty, ST7789_Backlight_Get(),
+             (unsigned long)TIM2->CCR3);
+      check_fail++;
+    }
+    ST7789_Backlight_FadeTo(0, 10); // 不足32ms时每毫秒一级
+    HAL_Delay(10);
+    if (ST7789_Backlight_IsFading() || TIM2->CCR3 != 0) {
+      printf("backlight: fade to 0 ended at duty %lu\n", (unsigned long)TIM2->CCR3);
+      check_fail++;
+    }
+    ST7789_Backlight_Set(255);
+  }
+
+  /* 内存池:其他块仍被占用时,重复释放同样被拒绝,不会把同一块链入空闲链表两次 */
+  {
+    ST7789_Pool *pool = ST7789_Pool_Create("check", 8, 3);
+    void *a = ST7789_Pool_Alloc(pool), *b = ST7789_Pool_Alloc(pool);
+    void *c, *d;
+    if (ST7789_Pool_Free(pool, a) != HAL_OK || ST7789_Pool_Free(pool, a) != HAL_ERROR || // b仍被占用
+        (c = ST7789_Pool_Alloc(pool)) == NULL || (d = ST7789_Pool_Alloc(pool)) == NULL || c == d || c == b ||
+        d == b || ST7789_Pool_Alloc(pool) != NULL) {
+      printf("pool: double free accepted\n");
+      check_fail++;
+    }
+  }
+  /* 条带缓冲应在内存区的"tile"池中 */
+  check_tile_pool = 0;
+  ST7789_Arena_Dump(check_arena);
+  if (!check_tile_pool) {
+    printf("tile pool: band not allocated from the arena\n");
+    check_fail++;
+  }
+
+  /* CRC仿真:写入的字等于当前结果(复位后写0xFFFFFFFF)时也要计入 */
+  CRC->CR = CRC_CR_RESET;
+  ST7789_CRC_WRITE(0xFFFFFFFFU);
+  if (CRC->DR != 0x00000000U) {
+    printf("crc: write equal to the current value was dropped\n");
+    check_fail++;
+  }
+}
+
+int main(void) {
+  printf("-- DMA completes immediately\n");
+  check_run();
+  printf("-- DMA completion deferred to WFI\n");
+  ST7789_Sim_SetDmaDeferred(1);
+  check_run();
+  ST7789_Sim_SetDmaDeferred(0);
+
+  printf(check_fail ? "FAILED (%d)\n" : "OK\n", check_fail);
+  return check_fail ? 1 : 0;
+}
@@ -0,0 +1,633 @@
+/**
+ * @name         : st7789_sim.c
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-19 15:30:16
+ * @brief        : ST7789 主机仿真后端实现
+ * DMA发送在仿真中立即完成,完成中断在PRIMASK为0且不在中断上下文时投递,
+ * 与硬件上关中断期间DMA完成中断被挂起的行为一致;也可以延后到WFI时投递(ST7789_Sim_SetDmaDeferred)
+ * @version      : V1.3
+ * V1.1 2026-10-20 06:10:42 增加延后投递DMA完成中断的模式,配合check.c回归检查
+ * V1.2 2026-10-20 09:02:27 CRC数据写入由sim_crc_write显式计入
+ * V1.3 2026-10-20 12:44:20 通道7每个节拍把渐变表的下一项写入TIM2->CCR3;置完成标志前先处理IFCR
+ */
+
+#include "st7789_sim.h"
+#include "my_st7789_2.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/* 替身HAL使用的全局对象 */
+SPI_HandleTypeDef hspi1 = {.State = HAL_SPI_STATE_READY};
+GPIO_TypeDef sim_gpioa;
+DWT_Type sim_dwt;
+CoreDebug_Type sim_coredebug;
+RCC_TypeDef sim_rcc;
+static CRC_TypeDef sim_crc = {.DR = 0xFFFFFFFFU};
+static uint32_t sim_crc_value = 0xFFFFFFFFU;
+TIM_TypeDef sim_tim2, sim_tim4;
+static DMA_TypeDef sim_dma1;
+static DMA_Channel_TypeDef sim_dma1_ch6;
+DMA_Channel_TypeDef sim_dma1_ch7;
+uint32_t SystemCoreClock = 72000000;
+
+/* 虚拟面板 */
+static uint16_t sim_gram[ST7789_SIM_GRAM_H][ST7789_SIM_GRAM_W];
+static ST7789_SimPanel sim_panel;
+static ST7789_SimStats sim_stats;
+
+/* 字节流解码状态 */
+static uint8_t sim_dc;       // DC引脚电平
+static uint8_t sim_rst = 1;  // RST引脚电平
+static uint8_t sim_cmd;      // 最近一条命令
+static uint8_t sim_param[4];
+static uint8_t sim_param_idx;
+static uint8_t sim_pix[3];
+static uint8_t sim_pix_idx;
+static uint16_t sim_c, sim_r; // RAM写地址计数器
+
+/* 时间 */
+static uint32_t sim_spi_hz = ST7789_SIM_DEFAULT_SPI_HZ;
+static uint32_t sim_gap_ns = ST7789_SIM_DEFAULT_GAP_NS;
+static uint64_t sim_time_ns;
+static uint64_t sim_last_sleep_change_ns;
+static uint8_t sim_sleep_changed;
+
+/* 中断仿真 */
+static uint32_t sim_primask;
+static uint8_t sim_in_isr;
+static uint8_t sim_dma_pending;
+static uint8_t sim_dma_defer;  // 为1时完成中断只在WFI时投递
+static uint32_t sim_dma_credit; // 延后模式下允许投递的完成中断个数
+
+static void sim_panel_reset(void) {
+  memset(&sim_panel, 0, sizeof(sim_panel));
+  sim_panel.colmod = ST7789_COLOR_MODE_18bit;
+  sim_panel.sleeping = 1;
+  sim_panel.xe = ST7789_SIM_GRAM_W - 1;
+  sim_panel.ye = ST7789_SIM_GRAM_H - 1;
+  sim_param_idx = 0;
+  sim_pix_idx = 0;
+  sim_cmd = ST7789_NOP;
+  sim_last_sleep_change_ns = sim_time_ns;
+  sim_sleep_changed = 1;
+}
+
+/**
+ * @brief 按MADCTL把地址计数器映射到GRAM物理坐标并写入一个像素
+ */
+static void sim_write_pixel(uint16_t color) {
+  uint8_t m = sim_panel.madctl;
+  int32_t pc, pr;
+
+  if (m & ST7789_MADCTL_MV) {
+    pr = (m & ST7789_MADCTL_MY) ? ST7789_SIM_GRAM_H - 1 - sim_c : sim_c;
+    pc = (m & ST7789_MADCTL_MX) ? ST7789_SIM_GRAM_W - 1 - sim_r : sim_r;
+  } else {
+    pc = (m & ST7789_MADCTL_MX) ? ST7789_SIM_GRAM_W - 1 - sim_c : sim_c;
+    pr = (m & ST7789_MADCTL_MY) ? ST7789_SIM_GRAM_H - 1 - sim_r : sim_r;
+  }
+  if (pc >= 0 && pc < ST7789_SIM_GRAM_W && pr >= 0 && pr < ST7789_SIM_GRAM_H) {
+    sim_gram[pr][pc] = color;
+  }
+
+  if (++sim_c > sim_panel.xe) {
+    sim_c = sim_panel.xs;
+    if (++sim_r > sim_panel.ye) {
+      sim_r = sim_panel.ys;
+    }
+  }
+}
+
+/**
+ * @brief 睡眠状态切换需与上一次切换(或复位)间隔至少120ms
+ */
+static void sim_check_sleep_spacing(void) {
+  if (sim_sleep_changed && sim_time_ns - sim_last_sleep_change_ns < 120000000ULL) {
+    sim_stats.timing_violations++;
+  }
+  sim_last_sleep_change_ns = sim_time_ns;
+  sim_sleep_changed = 1;
+}
+
+static void sim_command(uint8_t cmd) {
+  sim_stats.cmd_bytes++;
+  sim_cmd = cmd;
+  sim_param_idx = 0;
+  sim_pix_idx = 0;
+
+  switch (cmd) {
+  case ST7789_SWRESET:
+    sim_panel_reset();
+    break;
+  case ST7789_SLPIN:
+    sim_check_sleep_spacing();
+    sim_panel.sleeping = 1;
+    break;
+  case ST7789_SLPOUT:
+    sim_check_sleep_spacing();
+    sim_panel.sleeping = 0;
+    break;
+  case ST7789_INVOFF:
+    sim_panel.inverted = 0;
+    break;
+  case ST7789_INVON:
+    sim_panel.inverted = 1;
+    break;
+  case ST7789_DISPOFF:
+    sim_panel.display_on = 0;
+    break;
+  case ST7789_DISPON:
+    sim_panel.display_on = 1;
+    break;
+  case ST7789_CASET:
+    sim_stats.caset++;
+    break;
+  case ST7789_RASET:
+    sim_stats.raset++;
+    break;
+  case ST7789_RAMWR:
+    sim_stats.ramwr++;
+    sim_c = sim_panel.xs;
+    sim_r = sim_panel.ys;
+    break;
+  default:
+    break;
+  }
+}
+
+static void sim_data(uint8_t b) {
+  if (sim_cmd == ST7789_RAMWR || sim_cmd == 0x3C) { // 0x3C: RAMWRC,从当前地址继续写
+    sim_stats.pixel_bytes++;
+    sim_pix[sim_pix_idx++] = b;
+    if (sim_panel.colmod == ST7789_COLOR_MODE_16bit && sim_pix_idx == 2) {
+      sim_write_pixel((uint16_t)(sim_pix[0] << 8) | sim_pix[1]);
+      sim_pix_idx = 0;
+    } else if (sim_panel.colmod != ST7789_COLOR_MODE_16bit && sim_pix_idx == 3) {
+      sim_write_pixel((uint16_t)(((sim_pix[0] >> 3) << 11) | ((sim_pix[1] >> 2) << 5) | (sim_pix[2] >> 3)));
+      sim_pix_idx = 0;
+    }
+    return;
+  }
+
+  sim_stats.param_bytes++;
+  if (sim_param_idx < sizeof(sim_param)) {
+    sim_param[sim_param_idx] = b;
+  }
+  sim_param_idx++;
+
+  switch (sim_cmd) {
+  case ST7789_MADCTL:
+    sim_panel.madctl = b;
+    break;
+  case ST7789_COLMOD:
+    sim_panel.colmod = b;
+    break;
+  case ST7789_CASET:
+    if (sim_param_idx == 4) {
+      sim_panel.xs = (sim_param[0] << 8) | sim_param[1];
+      sim_panel.xe = (sim_param[2] << 8) | sim_param[3];
+    }
+    break;
+  case ST7789_RASET:
+    if (sim_param_idx == 4) {
+      sim_panel.ys = (sim_param[0] << 8) | sim_param[1];
+      sim_panel.ye = (sim_param[2] << 8) | sim_param[3];
+    }
+    break;
+  default:
+    break;
+  }
+}
+
+static void sim_bus(const uint8_t *data, uint16_t len) {
+  sim_stats.transactions++;
+  sim_time_ns += sim_gap_ns + (uint64_t)len * 8 * 1000000000ULL / sim_spi_hz;
+  sim_dwt.CYCCNT += (uint32_t)((uint64_t)len * 8 * SystemCoreClock / sim_spi_hz);
+
+  for (uint16_t i = 0; i < len; i++) {
+    if (sim_dc) {
+      sim_data(data[i]);
+    } else {
+      sim_command(data[i]);
+    }
+  }
+}
+
+/**
+ * @brief 在允许的时机投递DMA完成中断
+ * @note 回调中再次启动的DMA在同一循环里继续投递,不会递归
+ */
+static void sim_irq_poll(void) {
+  if (sim_primask || sim_in_isr) {
+    return;
+  }
+  sim_in_isr = 1;
+  while (sim_dma_pending && !sim_primask) {
+    if (sim_dma_defer) {
+      if (sim_dma_credit == 0) {
+        break;
+      }
+      sim_dma_credit--;
+    }
+    sim_dma_pending = 0;
+    hspi1.State = HAL_SPI_STATE_READY;
+    HAL_SPI_TxCpltCallback(&hspi1);
+  }
+  sim_in_isr = 0;
+}
+
+/* ------------------------------ 替身HAL ------------------------------ */
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout) {
+  (void)Timeout;
+  if (hspi->State != HAL_SPI_STATE_READY) {
+    sim_stats.dropped++;
+    return HAL_BUSY;
+  }
+  sim_bus(pData, Size);
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size) {
+  if (hspi->State != HAL_SPI_STATE_READY) {
+    sim_stats.dropped++;
+    return HAL_BUSY;
+  }
+  hspi->State = HAL_SPI_STATE_BUSY_TX;
+  sim_stats.dma_transactions++;
+  sim_bus(pData, Size);
+  sim_dma_pending = 1;
+  sim_irq_poll();
+  return HAL_OK;
+}
+
+HAL_SPI_StateTypeDef HAL_SPI_GetState(SPI_HandleTypeDef *hspi) {
+  return hspi->State;
+}
+
+__attribute__((weak)) void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi) {
+  (void)hspi;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState) {
+  if (PinState == GPIO_PIN_SET) {
+    GPIOx->ODR |= GPIO_Pin;
+  } else {
+    GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+  }
+  if (GPIOx != ST7789_DC_PORT && GPIOx != ST7789_RST_PORT) {
+    return;
+  }
+  if (GPIO_Pin == ST7789_DC_PIN) {
+    sim_dc = PinState == GPIO_PIN_SET;
+  }
+  if (GPIO_Pin == ST7789_RST_PIN) {
+    if (!sim_rst && PinState == GPIO_PIN_SET) {
+      sim_panel_reset(); // 复位释放时面板寄存器恢复默认值
+    }
+    sim_rst = PinState == GPIO_PIN_SET;
+  }
+}
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init) {
+  (void)GPIOx;
+  (void)GPIO_Init;
+}
+
+uint32_t HAL_RCC_GetPCLK1Freq(void) {
+  return SystemCoreClock;
+}
+
+/* CRC单元: 多项式0x04C11DB7,初值0xFFFFFFFF,按32位字从高位开始移入,不反转,不异或输出 */
+CRC_TypeDef *sim_crc_access(void) {
+  if (sim_crc.CR & CRC_CR_RESET) {
+    sim_crc.CR &= ~CRC_CR_RESET;
+    sim_crc_value = 0xFFFFFFFFU;
+  }
+  sim_crc.DR = sim_crc_value;
+  return &sim_crc;
+}
+
+/**
+ * @brief 向DR写入一个字并计入CRC32
+ * @note 先经过sim_crc_access,处理上一条语句写入CR的复位位
+ */
+void sim_crc_write(uint32_t v) {
+  uint32_t c = sim_crc_access()->DR ^ v;
+
+  for (int i = 0; i < 32; i++) {
+    c = (c & 0x80000000U) ? (c << 1) ^ 0x04C11DB7U : c << 1;
+  }
+  sim_crc_value = c;
+  sim_crc.DR = c;
+}
+
+/**
+ * @brief 处理上次访问后写入的IFCR,再完成已使能的MEM2MEM传输
+ * @note 只仿真通道6;传输立即完成,没有总线仲裁和传输错误
+ */
+static void sim_dma1_update(void) {
+  for (int ch = 0; ch < 7; ch++) {
+    uint32_t f = (sim_dma1.IFCR >> (ch * 4)) & 0xF;
+    sim_dma1.ISR &= ~(((f & 1) ? 0xFU : f) << (ch * 4)); // CGIF清除该通道全部标志
+  }
+  sim_dma1.IFCR = 0;
+
+  DMA_Channel_TypeDef *c = &sim_dma1_ch6;
+  if ((c->CCR & (DMA_CCR_EN | DMA_CCR_MEM2MEM)) != (DMA_CCR_EN | DMA_CCR_MEM2MEM) || c->CNDTR == 0) {
+    return;
+  }
+  uint32_t psize = 1U << ((c->CCR >> 8) & 3), msize = 1U << ((c->CCR >> 10) & 3);
+  uint8_t *src = (uint8_t *)c->CPAR, *dst = (uint8_t *)c->CMAR;
+  while (c->CNDTR > 0) {
+    uint32_t v = 0;
+    memcpy(&v, src, psize); // 小端,PSIZE与MSIZE不同时按硬件规则截断或补零
+    memcpy(dst, &v, msize);
+    if (c->CCR & DMA_CCR_PINC) {
+      src += psize;
+    }
+    if (c->CCR & DMA_CCR_MINC) {
+      dst += msize;
+    }
+    c->CNDTR--;
+  }
+  sim_dma1.ISR |= DMA_ISR_TCIF6;
+}
+
+DMA_TypeDef *sim_dma1_access(void) {
+  sim_dma1_update();
+  return &sim_dma1;
+}
+
+DMA_Channel_TypeDef *sim_dma1_ch6_access(void) {
+  sim_dma1_update();
+  return &sim_dma1_ch6;
+}
+
+/* 通道7已传输的项数,对应硬件内部的当前存储器地址,通道使能时从CMAR重新开始 */
+static uint32_t sim_ch7_done;
+
+DMA_Channel_TypeDef *sim_dma1_ch7_access(void) {
+  if (!(sim_dma1_ch7.CCR & DMA_CCR_EN)) {
+    sim_ch7_done = 0;
+  }
+  return &sim_dma1_ch7;
+}
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority) {
+  (void)IRQn;
+  (void)PreemptPriority;
+  (void)SubPriority;
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn) {
+  (void)IRQn;
+}
+
+__attribute__((weak)) void ST7789_Backlight_DMA_IRQHandler(void) {
+}
+
+/**
+ * @brief 推进TIM4节拍驱动的DMA1通道7(背光渐变)
+ * @note 每个节拍把渐变表的下一项写入CPAR(TIM2->CCR3),结束时模拟完成中断
+ */
+static void sim_tim4_advance(uint32_t ms) {
+  static uint32_t ticks;
+
+  if (!(sim_tim4.CR1 & TIM_CR1_CEN) || !(sim_dma1_ch7.CCR & DMA_CCR_EN)) {
+    ticks = 0;
+    return;
+  }
+  ticks += ms * (SystemCoreClock / 1000) / (sim_tim4.PSC + 1);
+  while (ticks > sim_tim4.ARR && sim_dma1_ch7.CNDTR > 0) {
+    DMA_Channel_TypeDef *c = &sim_dma1_ch7;
+    uint32_t psize = 1U << ((c->CCR >> 8) & 3), msize = 1U << ((c->CCR >> 10) & 3);
+    uint32_t v = 0;
+    ticks -= sim_tim4.ARR + 1;
+    memcpy(&v, (const uint8_t *)c->CMAR + ((c->CCR & DMA_CCR_MINC) ? sim_ch7_done * msize : 0), msize);
+    memcpy((uint8_t *)c->CPAR, &v, psize);
+    sim_ch7_done++;
+    c->CNDTR--;
+  }
+  if (sim_dma1_ch7.CNDTR == 0) {
+    ticks = 0;
+    sim_dma1_update(); // 先处理驱动之前写入的IFCR,否则会清掉这里新置的标志
+    sim_dma1.ISR |= DMA_ISR_TCIF7;
+    if (sim_dma1_ch7.CCR & DMA_CCR_TCIE) {
+      ST7789_Backlight_DMA_IRQHandler();
+    }
+    sim_dma1.ISR &= ~DMA_ISR_TCIF7; // 替代驱动对IFCR的写入
+  }
+}
+
+void HAL_Delay(uint32_t Delay) {
+  sim_time_ns += (uint64_t)Delay * 1000000ULL;
+  sim_dwt.CYCCNT += Delay * (SystemCoreClock / 1000);
+  sim_tim4_advance(Delay);
+}
+
+uint32_t HAL_GetTick(void) {
+  return (uint32_t)(sim_time_ns / 1000000ULL);
+}
+
+uint32_t __get_PRIMASK(void) {
+  return sim_primask;
+}
+
+void __set_PRIMASK(uint32_t priMask) {
+  sim_primask = priMask;
+  sim_irq_poll();
+}
+
+void __disable_irq(void) {
+  sim_primask = 1;
+}
+
+void __enable_irq(void) {
+  __set_PRIMASK(0);
+}
+
+/* 在DMA完成中断中返回DMA1_Channel3的异常号 */
+uint32_t __get_IPSR(void) {
+  return sim_in_isr ? 16 + DMA1_Channel3_IRQn : 0;
+}
+
+/* DMA在仿真中立即完成,完成中断在恢复PRIMASK时投递,WFI无需等待;
+   延后模式下每次WFI相当于等到一次传输完成 */
+void __WFI(void) {
+  if (sim_dma_defer && sim_dma_pending) {
+    sim_dma_credit = 1;
+  }
+}
+
+/* ------------------------------ 仿真接口 ------------------------------ */
+
+/**
+ * @brief 复位虚拟面板,清空GRAM和统计
+ */
+void ST7789_Sim_Reset(void) {
+  memset(sim_gram, 0, sizeof(sim_gram));
+  sim_panel_reset();
+  sim_sleep_changed = 0;
+  ST7789_Sim_ClearStats();
+  hspi1.State = HAL_SPI_STATE_READY;
+  sim_dma_pending = 0;
+  sim_dma_credit = 0;
+}
+
+/**
+ * @brief DMA完成中断的投递方式
+ * @param on 0: 发送后立即投递(默认); 1: 只在驱动WFI等待时逐个投递,
+ *           主循环在传输期间继续运行,与硬件上DMA需要时间的行为一致,可以暴露阻塞接口与队列的交错问题
+ */
+void ST7789_Sim_SetDmaDeferred(uint8_t on) {
+  sim_dma_defer = on;
+  sim_dma_credit = 0;
+}
+
+/**
+ * @brief 延后模式下让最多n次DMA传输完成,相当于主循环继续运行期间队列在后台推进
+ */
+void ST7789_Sim_RunDma(uint32_t n) {
+  if (!sim_dma_defer) {
+    return;
+  }
+  sim_dma_credit = n;
+  sim_irq_poll();
+  sim_dma_credit = 0;
+}
+
+/**
+ * @brief 设置估算线上时间用的SPI时钟和每次传输的固定开销
+ */
+void ST7789_Sim_SetSpiClock(uint32_t hz, uint32_t gap_ns) {
+  sim_spi_hz = hz ? hz : ST7789_SIM_DEFAULT_SPI_HZ;
+  sim_gap_ns = gap_ns;
+}
+
+ST7789_SimStats ST7789_Sim_Stats(void) {
+  return sim_stats;
+}
+
+void ST7789_Sim_ClearStats(void) {
+  memset(&sim_stats, 0, sizeof(sim_stats));
+}
+
+/**
+ * @brief 两次快照之差,用于统计单个操作
+ */
+ST7789_SimStats ST7789_Sim_Diff(const ST7789_SimStats *after, const ST7789_SimStats *before) {
+  ST7789_SimStats d;
+  d.transactions = after->transactions - before->transactions;
+  d.dma_transactions = after->dma_transactions - before->dma_transactions;
+  d.cmd_bytes = after->cmd_bytes - before->cmd_bytes;
+  d.param_bytes = after->param_bytes - before->param_bytes;
+  d.pixel_bytes = after->pixel_bytes - before->pixel_bytes;
+  d.caset = after->caset - before->caset;
+  d.raset = after->raset - before->raset;
+  d.ramwr = after->ramwr - before->ramwr;
+  d.dropped = after->dropped - before->dropped;
+  d.timing_violations = after->timing_violations - before->timing_violations;
+  return d;
+}
+
+/**
+ * @brief 按当前SPI时钟估算一组统计对应的线上时间
+ */
+uint32_t ST7789_Sim_WireTimeUs(const ST7789_SimStats *s) {
+  uint64_t bytes = (uint64_t)s->cmd_bytes + s->param_bytes + s->pixel_bytes;
+  uint64_t ns = bytes * 8 * 1000000000ULL / sim_spi_hz + (uint64_t)s->transactions * sim_gap_ns;
+  return (uint32_t)(ns / 1000);
+}
+
+/**
+ * @brief 仿真时间(线上时间与HAL_Delay之和)
+ */
+uint64_t ST7789_Sim_TimeUs(void) {
+  return sim_time_ns / 1000;
+}
+
+const ST7789_SimPanel *ST7789_Sim_Panel(void) {
+  return &sim_panel;
+}
+
+/**
+ * @brief 读取面板可见区域的一个像素(物理坐标,RGB565)
+ */
+uint16_t ST7789_Sim_Pixel(uint16_t x, uint16_t y) {
+  if (x >= ST7789_SIM_GRAM_W || y >= ST7789_SIM_GRAM_H) {
+    return 0;
+  }
+  return sim_gram[y][x];
+}
+
+/**
+ * @brief 把可见区域导出为PPM(P6)图片
+ * @return 0 成功, -1 文件无法写入
+ */
+int ST7789_Sim_DumpPPM(const char *path) {
+  FILE *f = fopen(path, "wb");
+  if (f == NULL) {
+    return -1;
+  }
+  fprintf(f, "P6\n%d %d\n255\n", ST7789_SIM_GRAM_W, ST7789_SIM_VIEW_H);
+  for (uint16_t y = 0; y < ST7789_SIM_VIEW_H; y++) {
+    for (uint16_t x = 0; x < ST7789_SIM_GRAM_W; x++) {
+      uint16_t c = sim_gram[y][x];
+      uint8_t rgb[3] = {
+          (uint8_t)(((c >> 11) & 0x1F) * 255 / 31),
+          (uint8_t)(((c >> 5) & 0x3F) * 255 / 63),
+          (uint8_t)((c & 0x1F) * 255 / 31),
+      };
+      fwrite(rgb, 1, sizeof(rgb), f);
+    }
+  }
+  fclose(f);
+  return 0;
+}
+
+void ST7789_Sim_PrintStats(const char *label, const ST7789_SimStats *s) {
+  printf("%-24s xfers=%lu (dma %lu) cmd=%lu param=%lu pixel=%lu caset=%lu raset=%lu ramwr=%lu"
+         " dropped=%lu timing=%lu wire=%luus\n",
+         label, (unsigned long)s->transactions, (unsigned long)s->dma_transactions,
+         (unsigned long)s->cmd_bytes, (unsigned long)s->param_bytes, (unsigned long)s->pixel_bytes,
+         (unsigned long)s->caset, (unsigned long)s->raset, (unsigned long)s->ramwr,
+         (unsigned long)s->dropped, (unsigned long)s->timing_violations,
+         (unsigned long)ST7789_Sim_WireTimeUs(s));
+}
+
+/**
+ * @brief 检查统计是否超出预算
+ * @param max 各项上限,为0的项不检查;dropped和timing_violations始终要求为0
+ * @return 超出预算的项数,0表示通过
+ */
+int ST7789_Sim_CheckBudget(const char *label, const ST7789_SimStats *s, const ST7789_SimStats *max) {
+  int fail = 0;
+
+#define SIM_CHECK(field)                                                                    \
+  if (max->field && s->field > max->field) {                                                \
+    printf("%s: " #field " %lu > budget %lu\n", label, (unsigned long)s->field,             \
+           (unsigned long)max->field);                                                      \
+    fail++;                                                                                 \
+  }
+  SIM_CHECK(transactions)
+  SIM_CHECK(dma_transactions)
+  SIM_CHECK(cmd_bytes)
+  SIM_CHECK(param_bytes)
+  SIM_CHECK(pixel_bytes)
+  SIM_CHECK(caset)
+  SIM_CHECK(raset)
+  SIM_CHECK(ramwr)
+#undef SIM_CHECK
+
+  if (s->dropped) {
+    printf("%s: %lu transfers dropped while SPI busy\n", label, (unsigned long)s->dropped);
+    fail++;
+  }
+  if (s->timing_violations) {
+    printf("%s: %lu timing violations\n", label, (unsigned long)s->timing_violations);
+    fail++;
+  }
+  return fail;
+}
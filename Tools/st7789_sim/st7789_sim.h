@@ -0,0 +1,73 @@
+/**
+ * @name         : st7789_sim.h
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-19 15:30:16
+ * @brief        : ST7789 主机仿真后端
+ * 用替身HAL把my_st7789_2.c等驱动源码编译成主机程序,解码DC/SPI字节流驱动一块虚拟ST7789
+ * (GRAM, MADCTL, CASET/RASET, COLMOD),统计命令字节,参数字节,像素字节和传输次数,
+ * 按给定SPI时钟估算线上时间,并可把画面导出为PPM,用于CI中的回归和性能检查
+ *
+ * 回归检查在check.c中:运行有代表性的绘制操作,用ST7789_Sim_Stats/ST7789_Sim_CheckBudget判断传输量是否超出预算;
+ * 本目录的CMakeLists.txt用主机编译器构建并注册为ctest测试:
+ *   cmake -S Tools/st7789_sim -B build-sim && cmake --build build-sim && ctest --test-dir build-sim
+ * @version      : V1.1
+ * V1.1 2026-10-20 06:10:42 增加check.c回归检查和CMake构建,DMA完成中断可延后到WFI投递
+ */
+
+#ifndef __ST7789_SIM_H__
+#define __ST7789_SIM_H__
+
+#include "stm32f1xx_hal.h"
+
+/* 虚拟面板GRAM尺寸(ST7789控制器为240x320,240x240面板只显示前240行) */
+#define ST7789_SIM_GRAM_W 240
+#define ST7789_SIM_GRAM_H 320
+#define ST7789_SIM_VIEW_H 240
+
+/* 默认SPI时钟,与CubeMX配置的18Mbit/s一致 */
+#define ST7789_SIM_DEFAULT_SPI_HZ 18000000U
+/* 每次传输调用的固定开销(DC切换,HAL调用,DMA启动),用于估算线上时间 */
+#define ST7789_SIM_DEFAULT_GAP_NS 2000U
+
+typedef struct {
+  uint32_t transactions;      // SPI发送调用次数(阻塞+DMA)
+  uint32_t dma_transactions;  // 其中DMA发送次数
+  uint32_t cmd_bytes;         // DC低时发送的命令字节
+  uint32_t param_bytes;       // 命令参数字节(不含像素)
+  uint32_t pixel_bytes;       // RAMWR之后的像素字节
+  uint32_t caset;             // CASET命令次数
+  uint32_t raset;             // RASET命令次数
+  uint32_t ramwr;             // RAMWR命令次数
+  uint32_t dropped;           // SPI忙时被HAL拒绝的发送(驱动缺陷)
+  uint32_t timing_violations; // 违反手册时序的次数(SLPIN/SLPOUT间隔等)
+} ST7789_SimStats;
+
+/* 面板寄存器状态 */
+typedef struct {
+  uint8_t madctl;
+  uint8_t colmod;
+  uint8_t sleeping;
+  uint8_t display_on;
+  uint8_t inverted;
+  uint16_t xs, xe, ys, ye; // CASET/RASET
+} ST7789_SimPanel;
+
+void ST7789_Sim_Reset(void);
+void ST7789_Sim_SetSpiClock(uint32_t hz, uint32_t gap_ns);
+void ST7789_Sim_SetDmaDeferred(uint8_t on);
+void ST7789_Sim_RunDma(uint32_t n);
+
+ST7789_SimStats ST7789_Sim_Stats(void);
+void ST7789_Sim_ClearStats(void);
+ST7789_SimStats ST7789_Sim_Diff(const ST7789_SimStats *after, const ST7789_SimStats *before);
+uint32_t ST7789_Sim_WireTimeUs(const ST7789_SimStats *s);
+uint64_t ST7789_Sim_TimeUs(void);
+
+const ST7789_SimPanel *ST7789_Sim_Panel(void);
+uint16_t ST7789_Sim_Pixel(uint16_t x, uint16_t y);
+int ST7789_Sim_DumpPPM(const char *path);
+
+void ST7789_Sim_PrintStats(const char *label, const ST7789_SimStats *s);
+int ST7789_Sim_CheckBudget(const char *label, const ST7789_SimStats *s, const ST7789_SimStats *max);
+
+#endif
@@ -0,0 +1,214 @@
+/**
+ * @name         : stm32f1xx_hal.h
+ * @author       : 729DHS   guo_114@outlook.com
+ * @date         : 2026-10-19 15:30:16
+ * @brief        : ST7789 主机仿真用的HAL替身,只提供驱动用到的类型,函数和寄存器
+ * 编译仿真时把本目录放在包含路径最前面,驱动源码中的 #include "stm32f1xx_hal.h" 会解析到这里
+ * @version      : V1.2
+ * V1.1 2026-10-20 09:02:27 CRC数据写入改为显式的sim_crc_write,不再靠比较DR的值判断
+ * V1.2 2026-10-20 12:44:20 DMA1_Channel7经sim_dma1_ch7_access访问
+ */
+
+#ifndef __STM32F1xx_HAL_H
+#define __STM32F1xx_HAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define ST7789_SIM 1
+
+/* HAL 基本类型 */
+typedef enum {
+  HAL_OK = 0x00U,
+  HAL_ERROR = 0x01U,
+  HAL_BUSY = 0x02U,
+  HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+#define HAL_MAX_DELAY 0xFFFFFFFFU
+
+/* SPI */
+typedef enum {
+  HAL_SPI_STATE_RESET = 0x00U,
+  HAL_SPI_STATE_READY = 0x01U,
+  HAL_SPI_STATE_BUSY = 0x02U,
+  HAL_SPI_STATE_BUSY_TX = 0x03U,
+} HAL_SPI_StateTypeDef;
+
+typedef struct __SPI_HandleTypeDef {
+  volatile HAL_SPI_StateTypeDef State;
+} SPI_HandleTypeDef;
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size);
+HAL_SPI_StateTypeDef HAL_SPI_GetState(SPI_HandleTypeDef *hspi);
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi);
+
+/* GPIO */
+typedef struct {
+  uint32_t ODR;
+} GPIO_TypeDef;
+
+typedef enum {
+  GPIO_PIN_RESET = 0U,
+  GPIO_PIN_SET
+} GPIO_PinState;
+
+#define GPIO_PIN_0  ((uint16_t)0x0001)
+#define GPIO_PIN_1  ((uint16_t)0x0002)
+#define GPIO_PIN_2  ((uint16_t)0x0004)
+#define GPIO_PIN_3  ((uint16_t)0x0008)
+#define GPIO_PIN_4  ((uint16_t)0x0010)
+#define GPIO_PIN_5  ((uint16_t)0x0020)
+#define GPIO_PIN_6  ((uint16_t)0x0040)
+#define GPIO_PIN_7  ((uint16_t)0x0080)
+
+extern GPIO_TypeDef sim_gpioa;
+#define GPIOA (&sim_gpioa)
+
+typedef struct {
+  uint32_t Pin;
+  uint32_t Mode;
+  uint32_t Pull;
+  uint32_t Speed;
+} GPIO_InitTypeDef;
+
+#define GPIO_MODE_OUTPUT_PP   0x00000001U
+#define GPIO_MODE_AF_PP       0x00000002U
+#define GPIO_NOPULL           0x00000000U
+#define GPIO_SPEED_FREQ_LOW   0x00000002U
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init);
+
+/* RCC,时钟使能在仿真中没有作用 */
+typedef struct {
+  volatile uint32_t CFGR;
+  volatile uint32_t AHBENR;
+} RCC_TypeDef;
+
+extern RCC_TypeDef sim_rcc;
+#define RCC (&sim_rcc)
+#define RCC_CFGR_PPRE1      (0x7UL << 8U)
+#define RCC_CFGR_PPRE1_DIV1 0x00000000U
+#define RCC_AHBENR_DMA1EN   (0x1UL << 0U)
+#define RCC_AHBENR_CRCEN    (0x1UL << 6U)
+
+#define __HAL_RCC_GPIOA_CLK_ENABLE()
+#define __HAL_RCC_TIM2_CLK_ENABLE()
+#define __HAL_RCC_TIM4_CLK_ENABLE()
+#define __HAL_RCC_DMA1_CLK_ENABLE()
+
+uint32_t HAL_RCC_GetPCLK1Freq(void);
+
+/* CRC,结构体只是寄存器的影子:通过CRC宏访问时仿真先处理CR的复位位,再把DR置为当前结果;
+   普通的结构体赋值无法被仿真察觉,数据写入必须经过ST7789_CRC_WRITE(sim_crc_write)逐字计入,
+   所以写入值恰好等于当前结果时也不会漏算 */
+typedef struct {
+  volatile uint32_t DR;
+  volatile uint32_t IDR;
+  volatile uint32_t CR;
+} CRC_TypeDef;
+
+CRC_TypeDef *sim_crc_access(void);
+void sim_crc_write(uint32_t v);
+#define CRC           (sim_crc_access())
+#define ST7789_CRC_WRITE(v) sim_crc_write(v)
+#define CRC_CR_RESET  (0x1UL << 0U)
+
+/* NVIC */
+typedef enum {
+  DMA1_Channel3_IRQn = 13,
+  DMA1_Channel7_IRQn = 17,
+} IRQn_Type;
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority);
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
+
+/* TIM,只保存寄存器值;TIM4更新事件驱动的DMA1通道7由仿真按HAL_Delay推进 */
+typedef struct {
+  volatile uint32_t CR1, CR2, SMCR, DIER, SR, EGR, CCMR1, CCMR2, CCER, CNT, PSC, ARR, RCR;
+  volatile uint32_t CCR1, CCR2, CCR3, CCR4;
+} TIM_TypeDef;
+
+extern TIM_TypeDef sim_tim2, sim_tim4;
+#define TIM2 (&sim_tim2)
+#define TIM4 (&sim_tim4)
+
+#define TIM_CR1_CEN       (0x1UL << 0U)
+#define TIM_CR1_ARPE      (0x1UL << 7U)
+#define TIM_DIER_UDE      (0x1UL << 8U)
+#define TIM_EGR_UG        (0x1UL << 0U)
+#define TIM_CCMR2_CC3S    (0x3UL << 0U)
+#define TIM_CCMR2_OC3PE   (0x1UL << 3U)
+#define TIM_CCMR2_OC3M    (0x7UL << 4U)
+#define TIM_CCMR2_OC3M_1  (0x2UL << 4U)
+#define TIM_CCMR2_OC3M_2  (0x4UL << 4U)
+#define TIM_CCER_CC3E     (0x1UL << 8U)
+
+/* DMA,CPAR/CMAR为uintptr_t以便保存主机指针;
+   MEM2MEM通道在下一次通过DMA1或DMA1_Channel6宏访问时一次完成,与CRC一样一条语句最多访问一次 */
+typedef struct {
+  volatile uint32_t CCR, CNDTR;
+  volatile uintptr_t CPAR, CMAR;
+} DMA_Channel_TypeDef;
+
+typedef struct {
+  volatile uint32_t ISR, IFCR;
+} DMA_TypeDef;
+
+DMA_TypeDef *sim_dma1_access(void);
+DMA_Channel_TypeDef *sim_dma1_ch6_access(void);
+DMA_Channel_TypeDef *sim_dma1_ch7_access(void);
+#define DMA1          (sim_dma1_access())
+#define DMA1_Channel6 (sim_dma1_ch6_access())
+#define DMA1_Channel7 (sim_dma1_ch7_access())
+
+#define DMA_CCR_EN      (0x1UL << 0U)
+#define DMA_CCR_TCIE    (0x1UL << 1U)
+#define DMA_CCR_DIR     (0x1UL << 4U)
+#define DMA_CCR_PINC    (0x1UL << 6U)
+#define DMA_CCR_MINC    (0x1UL << 7U)
+#define DMA_CCR_PSIZE_0 (0x1UL << 8U)
+#define DMA_CCR_PSIZE_1 (0x2UL << 8U)
+#define DMA_CCR_MSIZE_0 (0x1UL << 10U)
+#define DMA_CCR_MSIZE_1 (0x2UL << 10U)
+#define DMA_CCR_MEM2MEM (0x1UL << 14U)
+#define DMA_ISR_TCIF6   (0x1UL << 21U)
+#define DMA_ISR_TEIF6   (0x1UL << 23U)
+#define DMA_IFCR_CGIF6  (0x1UL << 20U)
+#define DMA_ISR_TCIF7   (0x1UL << 25U)
+#define DMA_IFCR_CGIF7  (0x1UL << 24U)
+
+/* 时基 */
+void HAL_Delay(uint32_t Delay);
+uint32_t HAL_GetTick(void);
+
+extern uint32_t SystemCoreClock;
+
+/* CMSIS 中断屏蔽,仿真中DMA完成中断只在PRIMASK为0时投递 */
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t priMask);
+void __disable_irq(void);
+void __enable_irq(void);
+void __WFI(void);
+uint32_t __get_IPSR(void);
+
+/* CMSIS DWT */
+typedef struct {
+  volatile uint32_t CTRL;
+  volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct {
+  volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+extern DWT_Type sim_dwt;
+extern CoreDebug_Type sim_coredebug;
+#define DWT       (&sim_dwt)
+#define CoreDebug (&sim_coredebug)
+#define DWT_CTRL_CYCCNTENA_Msk     (0x1UL)
+#define CoreDebug_DEMCR_TRCENA_Msk (1UL << 24U)
+
+#endif